@@ -88,6 +88,42 @@ namespace std
   };
 }
 
+/*
+Flat representation of the SCCs of an AF
+component[a] is the id of the SCC of argument a, the members of SCC i are stored in members[offsets[i]..offsets[i+1])
+SCCs are numbered in the order Tarjan's algorithm completes them, i.e., in reverse topological order
+Once computed for an AF, the decomposition is carried over to its reducts (see getReduct)
+*/
+struct SCCs {
+	std::vector<uint32_t> component;
+	std::vector<uint32_t> members;
+	std::vector<uint32_t> offsets;
+
+	bool is_computed() const { return !offsets.empty(); }
+	uint32_t num_sccs() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+	uint32_t scc_size(uint32_t i) const { return offsets[i+1] - offsets[i]; }
+	std::vector<uint32_t> get_scc(uint32_t i) const { return std::vector<uint32_t>(members.begin() + offsets[i], members.begin() + offsets[i+1]); }
+};
+
+/*
+Grounded labelling of an AF, 'in' and 'out' are bitsets over the argument ids, all other arguments are undecided
+For undecided arguments, num_attackers counts the attackers that are not labelled out
+Once computed for an AF, the labelling is carried over to its reducts (see getReduct)
+*/
+struct Labelling {
+	bool computed = false;
+	std::vector<uint64_t> in;
+	std::vector<uint64_t> out;
+	std::vector<uint32_t> num_attackers;
+
+	bool is_computed() const { return computed; }
+	bool is_in(uint32_t arg) const { return (in[arg >> 6] >> (arg & 63)) & 1; }
+	bool is_out(uint32_t arg) const { return (out[arg >> 6] >> (arg & 63)) & 1; }
+	bool is_undec(uint32_t arg) const { return !is_in(arg) && !is_out(arg); }
+	void set_in(uint32_t arg) { in[arg >> 6] |= uint64_t(1) << (arg & 63); }
+	void set_out(uint32_t arg) { out[arg >> 6] |= uint64_t(1) << (arg & 63); }
+};
+
 class AF {
 public:
 
@@ -109,6 +145,9 @@ std::vector<uint8_t> self_attack;
 std::unordered_map<std::pair<uint32_t,uint32_t>,bool> att_exists;
 std::unordered_map<std::pair<uint32_t,uint32_t>,bool> symmetric_attack;
 
+SCCs sccs;
+Labelling grounded;
+
 std::vector<int> accepted_var;
 std::vector<int> range_var;
 std::vector<int> rejected_var;
@@ -0,0 +1,47 @@
+#ifndef BRANCH_H
+#define BRANCH_H
+
+#include "Fingerprint.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// initial sets of one SCC or one framework, shared by all branches that add one of them
+typedef std::shared_ptr<const std::vector<std::vector<std::string>>> InitialSetList;
+
+/*
+Extension constructed along a branch of the search, as an immutable list of the initial sets that have been added
+All children of a branch share the list of their parent, so extending a branch only stores the argument keys of the new initial set
+and a pointer to it, which keeps the list it belongs to alive. The names are only resolved for printing.
+For the partial-order reduction, a branch also stores the keys of the SCCs whose initial sets must not be added next (see computeCommutingSCCs).
+*/
+class Branch {
+
+public:
+	Branch extend(std::shared_ptr<const std::vector<std::string>> initial_set, std::vector<uint64_t> blocked = std::vector<uint64_t>()) const;
+	Branch extend(const InitialSetList & sets, size_t index, std::vector<uint64_t> blocked = std::vector<uint64_t>()) const;
+	std::vector<std::string> arguments() const;
+	Fingerprint fingerprint() const;
+	Fingerprint search_fingerprint() const;
+	bool empty() const { return !head; }
+	size_t depth() const { return head ? head->depth : 0; }
+	bool blocks_any() const { return head && !head->blocked.empty(); }
+	bool blocks(uint64_t scc_key) const;
+	const std::vector<uint64_t> & blocked() const;
+
+private:
+	struct Node {
+		mutable std::shared_ptr<const Node> parent;
+		std::shared_ptr<const std::vector<std::string>> initial_set;
+		std::vector<uint64_t> keys;
+		size_t depth;
+		std::vector<uint64_t> blocked;
+
+		~Node();
+	};
+
+	std::shared_ptr<const Node> head;
+};
+
+#endif
@@ -33,6 +33,8 @@
 #ifndef CMSAT_SOLVER_H
 #define CMSAT_SOLVER_H
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -41,22 +43,29 @@
 /*
 Class that models the Crpytominisat5 SAT solver
 SAT calls are answered by directly asking the API of cryptominisat
+The cryptominisat instance lives as long as the object, so clauses learned in one call are kept for the next ones.
+Minimization clauses only hold for the next call, they are guarded by a fresh activation literal that is assumed in that call.
 */
 class CryptoMiniSatSolver {
 
 public:
 	std::vector<bool> model;
 	uint32_t n_vars; // number of vars
-	std::vector<std::vector<CMSat::Lit>> clauses;
+	uint32_t model_vars; // number of vars of the encodings, only these are copied into the model
     std::vector<std::vector<CMSat::Lit>> minimization_clauses;
 
 	CryptoMiniSatSolver(uint32_t number_of_vars, std::string path_to_solver);
-	~CryptoMiniSatSolver() {};
 	void addClause(const std::vector<int> & clause);
 	void addMinimizationClause(const std::vector<int> & clause);
+	int new_var();
 	int solve();
 	int solve(const std::vector<int> & assumptions);
 	void free();
+
+private:
+	// the instance keeps a pointer to the interrupt flag, so both are held by pointer and the object stays movable
+	std::unique_ptr<std::atomic<bool>> interrupt;
+	std::unique_ptr<CMSat::SATSolver> solver;
 };
 
 #endif
\ No newline at end of file
@@ -16,8 +16,10 @@ namespace Encodings {
 void add_rejected_clauses(const AF & af, SAT_Solver & solver);
 void add_nonempty(const AF & af, SAT_Solver & solver);
 void add_nonempty_subset_of(const AF & af, std::vector<uint32_t> args, SAT_Solver & solver);
+void add_grounded_out(const AF & af, const Labelling & grounded, SAT_Solver & solver);
 void add_conflict_free(const AF & af, SAT_Solver & solver);
 void add_admissible(const AF & af, SAT_Solver & solver);
+void add_admissible_in_reducts(const AF & af, const std::vector<int> & removed_var, SAT_Solver & solver);
 void add_complete(const AF & af, SAT_Solver & solver);
 
 }
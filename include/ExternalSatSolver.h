@@ -25,6 +25,7 @@ public:
     void assume(int lit);
     void addClause(std::vector<int> & clause);
     void addMinimizationClause(std::vector<int> & clause);
+    int new_var() { return ++n_vars; }
     int solve();
     int solve(const std::vector<int> assumptions);
     void free();
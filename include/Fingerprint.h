@@ -0,0 +1,98 @@
+#ifndef FINGERPRINT_H
+#define FINGERPRINT_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*
+128-bit fingerprint of a set of arguments, used to recognise branches that have already been explored
+*/
+struct Fingerprint {
+	uint64_t lo = 0;
+	uint64_t hi = 0;
+
+	bool operator==(const Fingerprint & other) const { return lo == other.lo && hi == other.hi; }
+	bool empty() const { return lo == 0 && hi == 0; }
+};
+
+struct FingerprintHash {
+	size_t operator()(const Fingerprint & fp) const { return fp.lo; }
+};
+
+// id of an argument that stays the same in all reducts of a framework
+uint64_t argument_key(const std::string & arg);
+
+// fingerprint of the set of arguments with the given keys, the order of the keys does not matter
+Fingerprint fingerprint(std::vector<uint64_t> keys);
+
+/*
+Concurrent set of fingerprints, split into independently locked shards
+Each shard is an open-addressing hash table, so an entry takes 16 bytes (plus free slots).
+*/
+class FingerprintSet {
+
+public:
+	// inserts the fingerprint, returns 'false' if it was already contained
+	bool insert(const Fingerprint & fp);
+	void clear();
+
+private:
+	static const uint32_t NUM_SHARDS = 64;
+
+	struct Shard {
+		std::mutex mtx;
+		std::vector<Fingerprint> table;
+		size_t count = 0;
+	};
+
+	Shard shards[NUM_SHARDS];
+};
+
+/*
+Concurrent map from fingerprints to values, sharded like FingerprintSet
+Values are copied out under the lock of their shard, so large values should be held by shared pointers.
+*/
+template <class T>
+class FingerprintMap {
+
+public:
+	bool find(const Fingerprint & fp, T & value) {
+		Shard & shard = shards[fp.hi % NUM_SHARDS];
+		std::lock_guard<std::mutex> lock(shard.mtx);
+		auto it = shard.map.find(fp);
+		if (it == shard.map.end()) {
+			return false;
+		}
+		value = it->second;
+		return true;
+	}
+
+	// keeps the value that was inserted first
+	void insert(const Fingerprint & fp, T value) {
+		Shard & shard = shards[fp.hi % NUM_SHARDS];
+		std::lock_guard<std::mutex> lock(shard.mtx);
+		shard.map.insert(std::make_pair(fp, std::move(value)));
+	}
+
+	void clear() {
+		for (auto & shard: shards) {
+			std::lock_guard<std::mutex> lock(shard.mtx);
+			shard.map.clear();
+		}
+	}
+
+private:
+	static const uint32_t NUM_SHARDS = 64;
+
+	struct Shard {
+		std::mutex mtx;
+		std::unordered_map<Fingerprint,T,FingerprintHash> map;
+	};
+
+	Shard shards[NUM_SHARDS];
+};
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef GZIP_STREAM_H
+#define GZIP_STREAM_H
+
+#include <streambuf>
+#include <string>
+
+#include <zlib.h>
+
+/*
+Read-only stream buffer on top of zlib's gzFile
+Handles gzip-compressed and plain input alike, since zlib passes uncompressed data through transparently.
+The path "-" reads from <stdin>, so frameworks can be piped in without writing them to disk first.
+A read error or a truncated compressed stream ends the input like end of file, failed() tells the two apart.
+*/
+class GzipStreamBuf : public std::streambuf {
+
+public:
+	GzipStreamBuf();
+	~GzipStreamBuf();
+	bool open(const std::string & path);
+	bool is_open() const;
+	bool failed() const { return error; }
+	void close();
+
+protected:
+	int_type underflow();
+
+private:
+	static const std::size_t buffer_size = 1 << 16;
+	gzFile file;
+	bool error;
+	char buffer[buffer_size];
+};
+
+#endif
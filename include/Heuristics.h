@@ -0,0 +1,90 @@
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+
+#include "AF.h"
+
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+Orders in which the branches of the DS searches are explored
+SOLVER_ORDER	branches are scheduled in the order the SAT solver returns the initial sets
+QUERY_DIRECTED	depth-first, prefer initial sets that attack defenders or attackers of the query
+QUERY_DISTANCE	depth-first, prefer initial sets close to the query, i.e., in the SCCs the query depends on most directly
+SHALLOW_FIRST	prefer branches with fewer initial sets (breadth-first)
+*/
+enum heuristic { SOLVER_ORDER, QUERY_DIRECTED, QUERY_DISTANCE, SHALLOW_FIRST, UNKNOWN_HEURISTIC };
+
+heuristic string_to_heuristic(const std::string & name);
+std::string heuristic_to_string(heuristic h);
+
+namespace Heuristics {
+
+// heuristic used by DS-PR and DS-UC, set via --heuristic
+extern heuristic branch_order;
+
+/*
+Scores the branches that extend the current extension by an initial set of 'af', higher scores are explored first
+The information about the query is computed once per framework, scoring an initial set then only looks at its arguments.
+*/
+class BranchScorer {
+
+public:
+	BranchScorer(const AF & af, uint32_t query, size_t depth);
+	int64_t score(const std::vector<uint32_t> & initial_set) const;
+
+private:
+	const AF & af;
+	size_t depth;
+	std::vector<uint8_t> role;			// QUERY_DIRECTED: 1 for attackers of the query, 2 for its defenders
+	std::vector<uint32_t> distance;		// QUERY_DISTANCE: length of the shortest attack path to the query
+};
+
+/*
+Concurrent priority queue of pending branches, among branches with equal score the newest is taken first
+Every push is paired with one posted task that pops the currently best branch, so the scheduler stays unaware of priorities.
+*/
+template <class T>
+class BranchQueue {
+
+public:
+	BranchQueue() : counter(0) {}
+
+	void push(T item, int64_t score) {
+		std::lock_guard<std::mutex> lock(mtx);
+		queue.push(Entry(std::make_pair(score, counter++), std::move(item)));
+	}
+
+	bool pop(T & item) {
+		std::lock_guard<std::mutex> lock(mtx);
+		if (queue.empty()) {
+			return false;
+		}
+		item = std::move(const_cast<Entry &>(queue.top()).second);
+		queue.pop();
+		return true;
+	}
+
+	void clear() {
+		std::lock_guard<std::mutex> lock(mtx);
+		queue = std::priority_queue<Entry, std::vector<Entry>, Compare>();
+	}
+
+private:
+	typedef std::pair<std::pair<int64_t,int64_t>, T> Entry;
+	struct Compare {
+		bool operator()(const Entry & a, const Entry & b) const { return a.first < b.first; }
+	};
+
+	std::mutex mtx;
+	std::priority_queue<Entry, std::vector<Entry>, Compare> queue;
+	int64_t counter;
+};
+
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include "AF.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+Preprocessing shared by all serialisation problems, applied once to the input framework
+An argument is dead if it attacks itself or is attacked by the grounded extension. Dead arguments are contained in no admissible set,
+of the framework or of any reduct by an admissible set (the grounded extension outside the added sets stays grounded in the reduct).
+DEAD_ATTACKS	attacks between two different dead arguments are dropped, no admissible set has to defend or avoid them
+INERT_ARGUMENTS	dead arguments that attack no live argument are removed, nothing has to be defended against them
+Both rules leave the admissible sets, initial sets, challenges and reducts unchanged, so all extensions and counts stay the same.
+*/
+namespace Kernel {
+
+enum rule { DEAD_ATTACKS, INERT_ARGUMENTS, NUM_RULES };
+
+struct Report {
+	uint64_t removed_args[NUM_RULES] = {0, 0};
+	uint64_t removed_attacks[NUM_RULES] = {0, 0};
+};
+
+std::string rule_to_string(rule r);
+
+/*
+Applies all rules to 'af', the argument 'keep' (the query, may be empty) is never removed and its attacks are kept
+@param atts		list of all attacks of the AF, attacks of the kernel are kept in their original order
+@returns 'false' if no rule applies, 'af' and 'atts' are then left untouched
+*/
+bool reduce(AF & af, std::vector<std::pair<std::string,std::string>> & atts, const std::string & keep, Report & report);
+
+void print_report(const Report & report, std::ostream & out);
+
+}
+
+#endif
@@ -3,6 +3,9 @@
 
 #include "Util.h"
 #include "Encodings.h"
+#include "Branch.h"
+
+#include <functional>
 
 namespace Problems {
 
@@ -18,6 +21,15 @@ bool se_initial(const AF & af);
 bool ee_initial(const AF & af);
 std::set<std::vector<std::string>> get_ua_or_uc_initial(const AF & af); // helper method to get only the unattacked and unchallenged initial sets
 
+// SAT enumeration of the initial sets within one SCC, and its fan-out over several SCCs (shared by EE-IT and CE-IT)
+void enumerate_scc_initial_sets(const AF & af, const std::vector<uint32_t> & scc, const Labelling & grounded, std::vector<std::vector<uint32_t>> & initial_sets);
+void for_each_scc_enumeration(const AF & af, uint32_t n, const std::function<void(uint32_t)> & fn);
+
+// initial sets of the SCCs enumerated so far, keyed by getSCCContextFingerprint and shared by all tasks
+extern FingerprintMap<InitialSetList> scc_initial_sets;
+void cache_initial_sets(const Fingerprint & key, InitialSetList initial_sets);
+void cache_initial_sets(const Fingerprint & key, std::vector<std::vector<std::string>> initial_sets);
+
 // CE-IT
 bool ce_initial(const AF & af); // counts the types of initial sets and their sizes
 
@@ -36,8 +48,9 @@ bool ee_unchallenged(const AF & af, std::vector<std::pair<std::string,std::strin
 // DS-PR
 bool mt_ds_preferred(const AF & af, std::string const & arg);
 bool ds_preferred(const AF & af, std::string const & arg, std::vector<std::pair<std::string,std::string>> & atts);
-bool ds_preferred_r(const AF & af, std::string const & arg, std::vector<std::pair<std::string,std::string>> & atts, std::vector<std::string> base_ext);
-bool ds_preferred_r_scc(const AF & af, std::string const & arg, std::vector<std::pair<std::string,std::string>> & atts, std::vector<std::string> base_ext, std::vector<uint32_t> scc);
+bool ds_preferred_r(const AF & af, std::string const & arg, std::vector<std::pair<std::string,std::string>> & atts, Branch base_ext);
+bool ds_preferred_r_scc(const AF & af, std::string const & arg, std::vector<std::pair<std::string,std::string>> & atts, Branch base_ext, std::vector<uint32_t> scc);
+extern bool incremental_sat; // DS-PR: encode the root framework once per thread and express reducts as assumptions
 
 //GROUNDED
 
@@ -0,0 +1,111 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class TaskGroup;
+
+/*
+Work-stealing scheduler shared by all parallel parts of the solver
+Every worker owns a deque: tasks posted by a worker are pushed to and taken from the back of its own deque,
+so the children of a task are processed depth-first on the same worker, while idle workers steal from the front of other deques.
+The scheduler is created on first use, with the number of threads set via set_num_threads (option -j) or the number of available CPUs.
+*/
+class Scheduler {
+
+public:
+	static Scheduler & instance();
+	static void set_num_threads(uint32_t num_threads);
+	static uint32_t available_cpus();
+
+	uint32_t num_threads() const { return workers.size(); }
+	void post(TaskGroup & group, std::function<void()> fn);
+
+	~Scheduler();
+
+private:
+	struct Task {
+		std::function<void()> fn;
+		TaskGroup * group;
+	};
+
+	struct Worker {
+		std::mutex mtx;
+		std::deque<Task> tasks;
+		std::thread thread;
+	};
+
+	Scheduler(uint32_t num_threads);
+	void work(uint32_t id);
+	bool try_run_one(int32_t id);
+	bool pop(int32_t id, Task & task);
+	void execute(Task & task);
+	uint64_t drop(TaskGroup & group);
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	Worker injection; // tasks posted from outside the pool
+
+	std::atomic<uint64_t> queued;
+	std::atomic<uint32_t> sleepers;
+	std::mutex sleep_mtx;
+	std::condition_variable sleep_cv;
+	bool stop;
+
+	static uint32_t requested_threads;
+	friend class TaskGroup;
+};
+
+/*
+Granularity policy: work below both thresholds is executed inline by the current task instead of being posted
+The cost of a task is estimated from the number of arguments and attacks it covers.
+*/
+struct Granularity {
+	static uint32_t min_task_size;
+	static uint64_t min_task_cost;
+
+	static bool spawn(uint32_t size, uint64_t attacks) { return size >= min_task_size || size + attacks >= min_task_cost; }
+};
+
+/*
+A set of tasks that can be waited for, tasks of a group may post further tasks to the same group
+A group is the scope of one query: once the answer is known, cancel() drops its queued tasks and interrupts the SAT calls of its running tasks.
+A group with a parent (e.g. a fan-out inside a task of the query) counts as cancelled once the parent is, and its SAT calls are interrupted with the parent's.
+*/
+class TaskGroup {
+
+public:
+	explicit TaskGroup(TaskGroup * parent = NULL) : pending(0), cancelled(false), parent(parent) {}
+	~TaskGroup();
+
+	void run(std::function<void()> fn) { Scheduler::instance().post(*this, std::move(fn)); }
+	void wait();
+	void cancel();
+	bool is_cancelled() const { return cancelled.load(std::memory_order_relaxed) || (parent != NULL && parent->is_cancelled()); }
+
+	// the group of the task running on the calling thread, NULL outside of tasks
+	static TaskGroup * current();
+	void add_interrupt(std::atomic<bool> * flag);
+	void remove_interrupt(std::atomic<bool> * flag);
+
+private:
+	std::atomic<uint64_t> pending;
+	std::atomic<bool> cancelled;
+	TaskGroup * parent;
+	std::mutex mtx;
+	std::condition_variable done_cv;
+	std::vector<std::atomic<bool>*> interrupts;
+
+	void finish_task();
+	friend class Scheduler;
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef SMALL_SCC_H
+#define SMALL_SCC_H
+
+#include "AF.h"
+
+#include <cstdint>
+#include <vector>
+
+/*
+SAT-free search for the initial sets within an SCC of at most 64 arguments
+The attacks within the SCC are stored as one 64-bit mask per argument, so conflict-freeness and defense of a candidate set are
+checked with a few bitwise operations. Enumerating with a SAT solver instead means encoding the whole framework for every SCC.
+*/
+namespace SmallSCC {
+
+const uint32_t MAX_ARGS = 64;
+
+// maximum number of sets visited by one search, beyond that the caller falls back to the SAT solver
+extern uint64_t node_limit;
+
+/*
+Enumerates the initial sets of 'af' within 'scc', i.e., the minimal non-empty admissible subsets of 'scc'
+@returns 'false' if the SCC has more than MAX_ARGS arguments or the search exceeded the node limit, 'initial_sets' is then unchanged
+*/
+bool initial_sets(const AF & af, const std::vector<uint32_t> & scc, std::vector<std::vector<uint32_t>> & initial_sets);
+
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef STRUCTURE_H
+#define STRUCTURE_H
+
+#include "AF.h"
+
+#include <cstdint>
+#include <vector>
+
+/*
+Shapes of SCCs whose initial sets are known in closed form
+ODD_CYCLE		a simple cycle of odd length: no initial set
+EVEN_CYCLE		a simple cycle of even length: the two alternating halves, unless a member is attacked from outside the SCC
+SYMMETRIC_SCC	all attacks between distinct members are symmetric: every member that neither attacks itself nor is attacked from outside on its own
+*/
+enum scc_shape { GENERAL_SCC, ODD_CYCLE, EVEN_CYCLE, SYMMETRIC_SCC };
+
+namespace Structure {
+
+scc_shape classify(const AF & af, const std::vector<uint32_t> & scc);
+
+/*
+Initial sets of 'af' within 'scc' if the SCC has one of the special shapes, each set sorted by argument id
+@returns 'false' for SCCs of general shape (and single arguments), 'initial_sets' is then unchanged
+*/
+bool initial_sets(const AF & af, const std::vector<uint32_t> & scc, std::vector<std::vector<uint32_t>> & initial_sets);
+
+/*
+A framework without cycles (all SCCs are single arguments that do not attack themselves) has the grounded extension as its only
+complete extension, its initial sets are its unattacked arguments, and serialising them in any order yields the grounded extension.
+*/
+bool is_acyclic(const AF & af, const SCCs & sccs);
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define UTIL_H
 
 #include "AF.h"
+#include "Fingerprint.h"
 
 #include <iostream>
 #include <set>
@@ -12,9 +13,55 @@ void print_extension_ee(const std::vector<std::string> & extension);
 void print_extension_ee(const std::set<std::string> & extension);
 
 AF getReduct(const AF & af, std::vector<std::string> ext, std::vector<std::pair<std::string,std::string>> & atts);
+std::vector<uint64_t> getArgumentKeys(const AF & af);
+std::vector<uint8_t> getUpstreamArguments(const AF & af, uint32_t arg);
+AF getRestriction(const AF & af, const std::vector<uint8_t> & keep, std::vector<std::pair<std::string,std::string>> & atts);
 
-std::vector<std::vector<uint32_t>> computeStronglyConnectedComponents(const AF & af);
-void print_sccs(const AF & af, std::vector<std::vector<uint32_t>> sccs);
+/*
+Working memory of the SCC computation, kept between calls so that repeated decompositions do not allocate
+*/
+struct SCCScratch {
+	std::vector<uint32_t> index;
+	std::vector<uint32_t> lowlink;
+	std::vector<uint8_t> stack_member;
+	std::vector<uint32_t> arg_stack;
+	std::vector<std::pair<uint32_t,uint32_t>> call_stack;
+};
+
+void computeStronglyConnectedComponents(const AF & af, SCCs & sccs, SCCScratch & scratch);
+void computeStronglyConnectedComponents(const AF & af, SCCs & sccs);
+void computeStronglyConnectedComponentsParallel(const AF & af, SCCs & sccs, uint32_t num_threads);
+void refineStronglyConnectedComponents(const AF & af, const AF & reduct, const std::vector<uint32_t> & origin, SCCs & sccs);
+void print_sccs(const AF & af, const SCCs & sccs);
+uint32_t computeWeaklyConnectedComponents(const AF & af, std::vector<uint32_t> & component);
+std::vector<uint8_t> getAttackedFromOutside(const AF & af, const std::vector<uint32_t> & scc);
+Fingerprint getSCCContextFingerprint(const AF & af, const SCCs & sccs, uint32_t scc);
+std::vector<uint64_t> computeSCCKeys(const AF & af, const SCCs & sccs);
+std::vector<std::vector<uint64_t>> computeCommutingSCCs(const AF & af, const SCCs & sccs, const std::vector<uint64_t> & keys, const std::vector<uint8_t> & candidates);
+
+/*
+Partial-order reduction data of one framework, SCC keys and the commuting SCCs of all candidates are computed on first use
+The SCCs of the framework have to be computed. Only the SCCs marked in 'candidates' (those that can have initial sets) are ever blocked.
+*/
+class CommutingSCCs {
+public:
+	CommutingSCCs(const AF & af, std::vector<uint8_t> candidates) : af(af), candidates(std::move(candidates)) {}
+	uint64_t key(uint32_t scc);
+	const std::vector<uint64_t> & get(uint32_t scc);
+
+private:
+	const AF & af;
+	std::vector<uint8_t> candidates;
+	std::vector<uint64_t> keys;
+	std::vector<std::vector<uint64_t>> commuting;
+};
+
+std::vector<std::vector<uint32_t>> getChallengeGraph(const AF & af, const std::vector<std::vector<uint32_t>> & sets);
+
+void computeGroundedLabelling(const AF & af, Labelling & lab);
+void computeGroundedLabellingParallel(const AF & af, Labelling & lab, uint32_t num_threads);
+void updateGroundedLabelling(const AF & af, const AF & reduct, const std::vector<uint32_t> & origin, const std::vector<uint32_t> & removed, Labelling & lab);
+std::vector<uint32_t> getGroundedExtension(const AF & af, const Labelling & lab);
 
 void log(int thread_id, int output);
 void log(int thread_id, std::string output);
@@ -0,0 +1,88 @@
+#include "Branch.h"
+
+#include <algorithm>
+
+using namespace std;
+
+Branch Branch::extend(shared_ptr<const vector<string>> initial_set, vector<uint64_t> blocked) const {
+	shared_ptr<Node> node = make_shared<Node>();
+	node->parent = head;
+	node->depth = depth() + 1;
+	node->blocked = move(blocked);
+	node->keys.reserve(initial_set->size());
+	for (auto const& arg: *initial_set) {
+		node->keys.push_back(argument_key(arg));
+	}
+	node->initial_set = move(initial_set);
+	Branch branch;
+	branch.head = node;
+	return branch;
+}
+
+// adds the initial set sets[index], the branch shares the ownership of the whole list
+Branch Branch::extend(const InitialSetList & sets, size_t index, vector<uint64_t> blocked) const {
+	return extend(shared_ptr<const vector<string>>(sets, &(*sets)[index]), move(blocked));
+}
+
+// unlinks the chain of ancestors that are only owned by this node one by one, recursive destruction could overflow the stack on deep branches
+Branch::Node::~Node() {
+	shared_ptr<const Node> next = move(parent);
+	while (next && next.use_count() == 1) {
+		shared_ptr<const Node> ancestor = move(next->parent);
+		next = move(ancestor);
+	}
+}
+
+// the arguments of the extension, in the order they have been added
+vector<string> Branch::arguments() const {
+	vector<const Node *> path;
+	size_t size = 0;
+	for (const Node * node = head.get(); node != NULL; node = node->parent.get()) {
+		path.push_back(node);
+		size += node->initial_set->size();
+	}
+	vector<string> extension;
+	extension.reserve(size);
+	for (auto it = path.rbegin(); it != path.rend(); ++it) {
+		extension.insert(extension.end(), (*it)->initial_set->begin(), (*it)->initial_set->end());
+	}
+	return extension;
+}
+
+// fingerprint of the extension
+Fingerprint Branch::fingerprint() const {
+	vector<uint64_t> keys;
+	for (const Node * node = head.get(); node != NULL; node = node->parent.get()) {
+		keys.insert(keys.end(), node->keys.begin(), node->keys.end());
+	}
+	return ::fingerprint(keys);
+}
+
+/*
+Fingerprint of the extension together with the blocked SCCs, which determine the subtree that is explored from the branch
+Deduplicating on the extension alone would be unsound with the partial-order reduction,
+since the first path reaching an extension may block initial sets that a later path would add.
+*/
+Fingerprint Branch::search_fingerprint() const {
+	vector<uint64_t> keys;
+	for (const Node * node = head.get(); node != NULL; node = node->parent.get()) {
+		keys.insert(keys.end(), node->keys.begin(), node->keys.end());
+	}
+	if (head) {
+		for (auto const& key: head->blocked) {
+			keys.push_back(~key);
+		}
+	}
+	return ::fingerprint(keys);
+}
+
+// keys of the SCCs whose initial sets are excluded in the next step
+const vector<uint64_t> & Branch::blocked() const {
+	static const vector<uint64_t> none;
+	return head ? head->blocked : none;
+}
+
+// whether initial sets of the SCC with the given key are excluded by the partial-order reduction
+bool Branch::blocks(uint64_t scc_key) const {
+	return head && binary_search(head->blocked.begin(), head->blocked.end(), scc_key);
+}
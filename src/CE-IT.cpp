@@ -1,139 +1,103 @@
 #include "Problems.h"
 #include "Encodings.h"
+#include "Scheduler.h"
 #include <iostream>
+#include <map>
 
 using namespace std;
 
 namespace Problems {
 
-set<vector<uint32_t>> get_all_initial(const AF & af) {
-    set<vector<uint32_t>> extensions;
+/*
+Counts of the initial sets by type, with a histogram of their sizes per type
+Only the summary is kept, so the memory does not grow with the number of initial sets.
+*/
+struct InitialSetCounts {
+    enum { UNATTACKED, UNCHALLENGED, CHALLENGED, NUM_TYPES };
 
-    vector<uint32_t> extension;
-    vector<int> complement_clause;
+    uint64_t num[NUM_TYPES] = {0, 0, 0};
+    map<uint32_t,uint64_t> sizes[NUM_TYPES];
 
-    complement_clause.reserve(af.args);
-	SAT_Solver solver = SAT_Solver(af.count, af.solver_path);
-    Encodings::add_admissible(af, solver);
-    Encodings::add_nonempty(af, solver);
-	while (true) {
-        // Compute one extension by finding a minimal solution to the KB
-        bool foundExt = false;
-        while (true) {
-            int sat = solver.solve();
-            if (sat==20) break;
-            // If we reach this once, an extension has been found
-            //cout << "======" << sat << "=======";
-            foundExt = true;
-            extension.clear();
-            for (uint32_t i = 0; i < af.args; i++) {
-                if (solver.model[af.accepted_var[i]]) {
-                    extension.push_back(i);
-                }
-            }
-            
-            vector<int> min_complement_clause;
-            min_complement_clause.reserve(af.args);
-            for (uint32_t i = 0; i < af.args; i++) {
-                if (solver.model[af.accepted_var[i]]) {
-                    // create a clause with all negated variables for the accepted arguments, makes sure the next found model (if it exists) is a subset of the current model
-                    min_complement_clause.push_back(-af.accepted_var[i]);
-                } else {
-                    // for all non-accepted arguments, at their negated acceptance variable to the solver, makes sure no non-accepted argument is accepted in the next found model
-                    vector<int> unit_clause = { -af.accepted_var[i] };
-                    solver.addMinimizationClause(unit_clause);
-                }
+    void add(int type, uint32_t size) {
+        num[type]++;
+        sizes[type][size]++;
+    }
+
+    void merge(const InitialSetCounts & other) {
+        for (int type = 0; type < NUM_TYPES; type++) {
+            num[type] += other.num[type];
+            for (auto const& entry: other.sizes[type]) {
+                sizes[type][entry.first] += entry.second;
             }
-            solver.addMinimizationClause(min_complement_clause);
-        }
-        if (foundExt) {
-            extensions.insert(extension);
-        } else {
-            break;
         }
+    }
+};
 
-        // create a complement clause, so that the solver doesnt find the same model again
-        // TODO can maybe be even more specific
-        complement_clause.clear();
-        for (uint32_t i = 0; i < af.args; i++) {
-            if (solver.model[af.accepted_var[i]]) {
-                complement_clause.push_back(-af.accepted_var[i]);
-            } else {
-                //complement_clause.push_back(-af.rejected_var[i]);
-            }
+// the sizes of one type in ascending order
+static void print_sizes(const map<uint32_t,uint64_t> & sizes) {
+    bool first = true;
+    for (auto const& entry: sizes) {
+        for (uint64_t k = 0; k < entry.second; k++) {
+            if (!first) cout << ",";
+            cout << entry.first;
+            first = false;
         }
-        solver.addClause(complement_clause);
-	}
-	return extensions;
+    }
+    cout << "\n";
 }
 
+/*
+The initial sets of the SCCs are enumerated in parallel and classified right away
+An initial set lies within one SCC, and two initial sets that attack each other lie in the same SCC (attacks between admissible sets go
+both ways), so whether an initial set is challenged is decided by the initial sets of its own SCC, which are dropped afterwards.
+*/
 bool ce_initial(const AF & af) {
-    set<vector<uint32_t>> extensions = get_all_initial(af);
-    uint32_t num_unattacked = 0;
-    uint32_t num_unchallenged = 0;
-    uint32_t num_challenged = 0;
-    vector<uint32_t> sizes_unattacked;
-    vector<uint32_t> sizes_unchallenged;
-    vector<uint32_t> sizes_challenged;
-    for (auto ext1: extensions) {
-        bool challenged = false;
-        bool unattacked = false;
-        if (ext1.size() == 1 && af.attackers[ext1[0]].size() == 0) {
-            unattacked = true;
-            num_unattacked++;
-            sizes_unattacked.push_back(1);
+    SCCs sccs;
+    computeStronglyConnectedComponents(af, sccs);
+    Labelling grounded;
+    computeGroundedLabelling(af, grounded);
+
+    InitialSetCounts counts;
+    vector<uint32_t> pending;
+    for (uint32_t i = 0; i < sccs.num_sccs(); i++) {
+        uint32_t first = sccs.members[sccs.offsets[i]];
+        if (sccs.scc_size(i) == 1 && af.unattacked[first]) {
+            counts.add(InitialSetCounts::UNATTACKED, 1);
             continue;
-        }        
-        for (auto ext2: extensions) {
-            if (ext1 == ext2) {
-                continue;
-            }
-            for (auto arg1: ext1) {
-                for (auto arg2: ext2) {
-                    try {
-                        if (af.att_exists.at(make_pair(arg1, arg2)) || af.att_exists.at(make_pair(arg2, arg1))) {
-                            challenged = true;
-                            num_challenged++;
-                            sizes_challenged.push_back(ext1.size());
-                            break;
-                        }
-                    }
-                    catch(const std::exception& e) {
-                        ;
-                    } 
-                }
-                if (challenged) {
-                    break;
-                }
-            }
-            if (challenged) {
-                break;
-            }
         }
-        if (!challenged && !unattacked) {
-            num_unchallenged++;
-            sizes_unchallenged.push_back(ext1.size());
-        } 
-    }
-    cout << extensions.size() << "," << num_unattacked << "," << num_unchallenged << "," << num_challenged << "\n";
-    for (uint32_t i = 0; i < sizes_unattacked.size(); i++) {
-        cout << sizes_unattacked[i];
-        if (i != sizes_unattacked.size()-1) cout << ",";
-    }
-    cout << "\n";
-    for (uint32_t i = 0; i < sizes_unchallenged.size(); i++) {
-        cout << sizes_unchallenged[i];
-        if (i != sizes_unchallenged.size()-1) cout << ",";
+        bool all_out = true;
+        for (uint32_t j = sccs.offsets[i]; j < sccs.offsets[i+1] && all_out; j++) {
+            all_out = grounded.is_out(sccs.members[j]);
+        }
+        if (!all_out) {
+            pending.push_back(i);
+        }
     }
-    cout << "\n";
-    for (uint32_t i = 0; i < sizes_challenged.size(); i++) {
-        cout << sizes_challenged[i];
-        if (i != sizes_challenged.size()-1) cout << ",";
+
+    mutex mtx;
+    for_each_scc_enumeration(af, pending.size(), [&](uint32_t k) {
+        vector<vector<uint32_t>> initial_sets;
+        enumerate_scc_initial_sets(af, sccs.get_scc(pending[k]), grounded, initial_sets);
+        InitialSetCounts scc_counts;
+        vector<vector<uint32_t>> challenges;
+        if (initial_sets.size() > 1) {
+            challenges = getChallengeGraph(af, initial_sets);
+        }
+        for (uint32_t i = 0; i < initial_sets.size(); i++) {
+            bool challenged = !challenges.empty() && !challenges[i].empty();
+            scc_counts.add(challenged ? InitialSetCounts::CHALLENGED : InitialSetCounts::UNCHALLENGED, initial_sets[i].size());
+        }
+        lock_guard<mutex> lock(mtx);
+        counts.merge(scc_counts);
+    });
+
+    uint64_t total = counts.num[InitialSetCounts::UNATTACKED] + counts.num[InitialSetCounts::UNCHALLENGED] + counts.num[InitialSetCounts::CHALLENGED];
+    cout << total << "," << counts.num[InitialSetCounts::UNATTACKED] << "," << counts.num[InitialSetCounts::UNCHALLENGED] << "," << counts.num[InitialSetCounts::CHALLENGED] << "\n";
+    for (int type = 0; type < InitialSetCounts::NUM_TYPES; type++) {
+        print_sizes(counts.sizes[type]);
     }
-    cout << "\n";
-    
 
 	return true;
 }
 
-}
\ No newline at end of file
+}
@@ -31,85 +31,115 @@
  */
 
 #include "CryptoMiniSatSolver.h"
+#include "Scheduler.h"
+
+#include <atomic>
 
 using namespace std;
 using namespace CMSat;
 
+namespace {
+
+// registers the interrupt flag of a SAT call with the task group of the calling thread
+class InterruptScope {
+public:
+	InterruptScope(std::atomic<bool> * flag) : flag(flag), group(TaskGroup::current()) {
+		if (group != NULL) {
+			group->add_interrupt(flag);
+		}
+	}
+	~InterruptScope() {
+		if (group != NULL) {
+			group->remove_interrupt(flag);
+		}
+	}
+	bool cancelled() const { return group != NULL && group->is_cancelled(); }
+
+private:
+	std::atomic<bool> * flag;
+	TaskGroup * group;
+};
+
+}
+
 CryptoMiniSatSolver::CryptoMiniSatSolver(uint32_t number_of_vars, std::string path_to_solver) {
 	n_vars = number_of_vars+1;
+	model_vars = n_vars;
 	model = vector<bool>(n_vars+1);
-	clauses = std::vector<std::vector<Lit>>();
-    minimization_clauses = std::vector<std::vector<Lit>>();
+	minimization_clauses = std::vector<std::vector<Lit>>();
+	interrupt.reset(new std::atomic<bool>(false));
+	solver.reset(new SATSolver(NULL, interrupt.get()));
+	solver->set_num_threads(1);
+	solver->new_vars(n_vars);
 }
 
-void CryptoMiniSatSolver::addClause(const vector<int> & clause) {
+static vector<Lit> to_lits(const vector<int> & clause) {
 	vector<Lit> lits(clause.size());
 	for (int i = 0; i < clause.size(); i++) {
 		int var = abs(clause[i]);
 		lits[i] = Lit(var, (clause[i] > 0) ? false : true);
 	}
-	clauses.push_back(lits);
+	return lits;
+}
+
+void CryptoMiniSatSolver::addClause(const vector<int> & clause) {
+	solver->add_clause(to_lits(clause));
 }
 
 void CryptoMiniSatSolver::addMinimizationClause(const vector<int> & clause) {
-	vector<Lit> lits(clause.size());
-	for (int i = 0; i < clause.size(); i++) {
-		int var = abs(clause[i]);
-		lits[i] = Lit(var, (clause[i] > 0) ? false : true);
-	}
-	minimization_clauses.push_back(lits);
+	minimization_clauses.push_back(to_lits(clause));
+}
+
+// adds a variable that is not used by the encodings, e.g. for activation literals
+int CryptoMiniSatSolver::new_var() {
+	solver->new_var();
+	return n_vars++;
 }
 
 int CryptoMiniSatSolver::solve() {
-	CMSat::SATSolver solver;
-	solver.set_num_threads(1);
-	solver.new_vars(n_vars);
-	for(auto const& clause: clauses) {
-		solver.add_clause(clause);
-	}
-	for(auto const& clause: minimization_clauses) {
-		solver.add_clause(clause);
-	}
-	minimization_clauses.clear();
-	bool sat = (solver.solve() == l_True);
-	model.clear();
-	if (sat) {
-		for (int i = 0; i < n_vars; i++) {
-			model[i] = (solver.get_model()[i] == l_True) ? true : false;
-		}
-	}
-	return sat ? 10 : 20;
+	return solve(vector<int>());
 }
 
 int CryptoMiniSatSolver::solve(const std::vector<int> & assumptions) {
-	// TODO never checked for correctness
-	CMSat::SATSolver solver;
-	solver.set_num_threads(1);
-	solver.new_vars(n_vars);
-	for(auto const& clause: clauses) {
-		solver.add_clause(clause);
+	// SAT calls inside a task are interrupted once the task group is cancelled, the result is then meaningless
+	InterruptScope scope(interrupt.get());
+	if (scope.cancelled()) {
+		return 20;
+	}
+	vector<Lit> lits = to_lits(assumptions);
+	// the minimization clauses of this call are only active under a fresh literal, which is retired afterwards
+	int activation = 0;
+	if (!minimization_clauses.empty()) {
+		activation = new_var();
+		for (auto & clause: minimization_clauses) {
+			clause.push_back(Lit(activation, true));
+			solver->add_clause(clause);
+		}
+		minimization_clauses.clear();
+		lits.push_back(Lit(activation, false));
 	}
-	for(auto const& clause: minimization_clauses) {
-		solver.add_clause(clause);
+	lbool result = solver->solve(&lits);
+	if (activation != 0) {
+		solver->add_clause(vector<Lit>(1, Lit(activation, true)));
 	}
-	minimization_clauses.clear();
-	vector<Lit> lits(assumptions.size());
-	for (int i = 0; i < assumptions.size(); i++) {
-		int var = abs(assumptions[i])-1;
-		lits[i] = Lit(var, (assumptions[i] > 0) ? false : true);
+	bool sat = (result == l_True);
+	if (result == l_Undef) {
+		return 20;
 	}
-	bool sat = (solver.solve(&lits) == l_True);
-	model.clear();
+	// after an unsatisfiable call, the model of the last satisfiable call is kept (the enumerations block it)
 	if (sat) {
-		for (int i = 0; i < n_vars; i++) {
-			model[i] = (solver.get_model()[i] == l_True) ? true : false;
+		// variables added by new_var() (activation literals and the like) are not part of the model
+		model.assign(model_vars+1, false);
+		const vector<lbool> & values = solver->get_model();
+		for (int i = 0; i < model_vars; i++) {
+			model[i] = (values[i] == l_True) ? true : false;
 		}
 	}
 	return sat ? 10 : 20;
 }
 
 void CryptoMiniSatSolver::free() {
-	clauses.clear();
 	minimization_clauses.clear();
 	model.clear();
-}
\ No newline at end of file
+	solver.reset();
+}
@@ -1,13 +1,14 @@
 #include "Problems.h"						// Header for all Problem methods
 
 #include <atomic>							// for tracking number of threads und status of counterexample search
-#include <mutex>							// for checking duplicate thread creating
-#include <stack>							// for computing the grounded extension
-#include <algorithm>						// std::find
-#include <thread>							// std::thread::hardware_concurrency()
+#include <algorithm>						// std::count, std::find
+#include <memory>							// std::unique_ptr
 
-#include <boost/asio/thread_pool.hpp>		// handles threads
-#include <boost/asio/post.hpp>				// for submitting tasks to thread pool
+#include "Fingerprint.h"					// for checking duplicate thread creating
+#include "Heuristics.h"						// for ordering the branches of the search
+#include "Scheduler.h"						// for submitting tasks to the shared scheduler
+#include "SmallSCC.h"						// for the SAT-free search of small SCCs
+#include "Structure.h"						// for SCCs with closed-form initial sets
 
 using namespace std;
 
@@ -19,17 +20,90 @@ atomic<int> thread_counter(0);
 atomic<bool> preferred_ce_found{false};
 
 // Structure for preventing duplicate thread creation
-set<set<string>> checked_branches;
-mutex mtx;
+FingerprintSet checked_branches;
 
-// Initialize Thread Pool with (#sys_threads - 1) number of threads
-int num_max_threads_dspr = std::thread::hardware_concurrency()-1;
-boost::asio::thread_pool pool(num_max_threads_dspr);
+/*
+Reducts (identified by their remaining arguments) whose search has been started
+The outcome of a search only depends on the reduct, so a reduct reached on another path is cut off at once:
+either its first search finds a counterexample, which ends the query, or the reduct has none.
+*/
+FingerprintSet explored_reducts;
+
+// Tasks of the current query, executed by the shared scheduler
+TaskGroup tasks_dspr;
+
+// Branches waiting to be explored, ordered by the selected heuristic
+Heuristics::BranchQueue<pair<AF,Branch>> branches_dspr;
+
+// Framework of the current query and a counter of the queries, for the incremental mode
+shared_ptr<const AF> root_af_dspr;
+atomic<uint64_t> query_dspr{0};
+
+// a counterexample decides the query: stop all other tasks
+static void found_counterexample() {
+	preferred_ce_found = true;
+	tasks_dspr.cancel();
+}
 
 namespace Problems {
 
+bool incremental_sat = false;
+
+/*
+Incremental solver of a worker thread for the framework of the current query
+The framework is encoded once with add_admissible_in_reducts, every reduct is then described by assumptions.
+The solver is rebuilt when the thread works on the next query.
+*/
+struct RootSolver {
+	uint64_t query = 0;
+	unique_ptr<SAT_Solver> solver;
+	vector<int> removed_var;
+};
+
+static RootSolver & root_solver() {
+	static thread_local RootSolver root;
+	if (!root.solver || root.query != query_dspr.load()) {
+		const AF & af = *root_af_dspr;
+		root.query = query_dspr.load();
+		root.solver.reset(new SAT_Solver(af.count, af.solver_path));
+		root.removed_var.resize(af.args);
+		for (uint32_t i = 0; i < af.args; i++) {
+			root.removed_var[i] = root.solver->new_var();
+		}
+		Encodings::add_admissible_in_reducts(af, root.removed_var, *root.solver);
+	}
+	return root;
+}
+
 /*
-helper function (threaded) for the DS-PR problem that catches simple cases and then starts new threads for each SCC
+Posts a task that explores the reduct of a new branch, small reducts are explored directly by the current task
+Unless the solver order is used, the branch is put into the priority queue and the task takes the best branch at the time it runs.
+*/
+static void post_branch(const AF & reduct, string const & arg, vector<pair<string,string>> & atts, Branch ext, int64_t score) {
+	uint64_t attacks = 0;
+	for (auto const& attackers: reduct.attackers) {
+		attacks += attackers.size();
+	}
+	if (!Granularity::spawn(reduct.args, attacks)) {
+		ds_preferred_r(reduct, arg, atts, ext);
+		return;
+	}
+	if (Heuristics::branch_order == SOLVER_ORDER) {
+		tasks_dspr.run([reduct, arg, &atts, ext] {ds_preferred_r(reduct, arg, atts, ext);});
+		return;
+	}
+	branches_dspr.push(make_pair(reduct, ext), score);
+	tasks_dspr.run([arg, &atts] {
+		pair<AF,Branch> branch;
+		if (branches_dspr.pop(branch)) {
+			ds_preferred_r(branch.first, arg, atts, branch.second);
+		}
+	});
+}
+
+/*
+helper function (threaded) for the DS-PR problem that catches simple cases and then branches on the initial sets of the first SCC
+upstream of 'arg' that has any
 
 @param af		the argumentation framework
 @param arg		the argument to be decided
@@ -38,11 +112,11 @@ helper function (threaded) for the DS-PR problem that catches simple cases and t
 
 @returns 'false' if the current extension is a counterexample for the skeptical acceptance of arg, 'true' if arg is accepted by the constructed extension
 */
-bool ds_preferred_r(const AF & af, string const & arg, vector<pair<string,string>> & atts, vector<string> base_ext) {
+bool ds_preferred_r(const AF & af, string const & arg, vector<pair<string,string>> & atts, Branch base_ext) {
 	#if defined(DEBUG_MODE)
 	int thread_id = thread_counter++;
 	log(thread_id, "STARTING THREAD FOR IS");
-	log(thread_id, "CURRENT", base_ext);
+	log(thread_id, "CURRENT", base_ext.arguments());
 	#endif
 
 	// check termination flag (some other thread found a counterexample)
@@ -58,7 +132,7 @@ bool ds_preferred_r(const AF & af, string const & arg, vector<pair<string,string
 		#if defined(DEBUG_MODE)
 		log(thread_id, "ARG SELF_ATTACKING --> TERM NO");
 		#endif
-		preferred_ce_found = true;
+		found_counterexample();
 		return false;
 	}
 
@@ -80,51 +154,29 @@ bool ds_preferred_r(const AF & af, string const & arg, vector<pair<string,string
 	If 'arg' is rejected by the grounded extension, we found an admissible extension, i.e., ext + grounded that does not contain 'arg'
 	If neither is the case, we move to the reduct wrt to the grounded extension to simplify
 	*/
-	vector<uint32_t> num_attackers;
-	num_attackers.resize(af.args, 0);
-	vector<string> grounded;
-	vector<bool> grounded_out;
-	grounded_out.resize(af.args, false);
-	stack<uint32_t> arg_stack;
-	for (size_t i = 0; i < af.args; i++) {
-		if (af.unattacked[i]) {
-			grounded.push_back(af.int_to_arg[i]);
-			arg_stack.push(i);
-		}
-		num_attackers[i] = af.attackers[i].size();
+	// The grounded labelling is carried over from the parent, only the initial set of this branch has been propagated
+	Labelling computed_grounded;
+	if (!af.grounded.is_computed()) {
+		computeGroundedLabelling(af, computed_grounded);
 	}
-	while (arg_stack.size() > 0) {
-		uint32_t a = arg_stack.top();
-		arg_stack.pop();
-		for (auto const& arg1: af.attacked[a]) {
-			if (grounded_out[arg1]) {
-				continue;
-			}
-			if (af.int_to_arg[arg1] == arg) {
-				#if defined(DEBUG_MODE)
-				log(thread_id, "GROUNDED REJECTS ARG --> TERM NO");
-				#endif
-				preferred_ce_found = true;
-				return false;
-			}
-			
-			grounded_out[arg1] = true;
-			for (auto const& arg2: af.attacked[arg1]) {
-				if (num_attackers[arg2] > 0) {
-					num_attackers[arg2]--;
-					if (num_attackers[arg2] == 0) {
-						if (af.int_to_arg[arg2] == arg) {
-							#if defined(DEBUG_MODE)
-							log(thread_id, "ARG GROUNDED --> TERM");
-							#endif
-							return true;
-						}
-						grounded.push_back(af.int_to_arg[arg2]);
-						arg_stack.push(arg2);
-					}
-				}
-			}
-		}
+	const Labelling & lab = af.grounded.is_computed() ? af.grounded : computed_grounded;
+	uint32_t arg_id = af.arg_to_int.find(arg)->second;
+	if (lab.is_out(arg_id)) {
+		#if defined(DEBUG_MODE)
+		log(thread_id, "GROUNDED REJECTS ARG --> TERM NO");
+		#endif
+		found_counterexample();
+		return false;
+	}
+	if (lab.is_in(arg_id)) {
+		#if defined(DEBUG_MODE)
+		log(thread_id, "ARG GROUNDED --> TERM");
+		#endif
+		return true;
+	}
+	vector<string> grounded;
+	for (auto const& a: getGroundedExtension(af, lab)) {
+		grounded.push_back(af.int_to_arg[a]);
 	}
 	AF new_af = af;
 	if (!grounded.empty()) {
@@ -142,21 +194,32 @@ bool ds_preferred_r(const AF & af, string const & arg, vector<pair<string,string
 		return true;
 	}
 
-	// Compute the SCCs of the current argumentation framework, we can then spawn one thread for each SCC to search for initial sets more effectively
-	vector<vector<uint32_t>> sccs = computeStronglyConnectedComponents(new_af);
-	#if defined(DEBUG_MODE)
-	log(thread_id, "COMPUTED SCCS");
-	#endif
-	
-	if (preferred_ce_found) {
+	/*
+	==================================================================================================================================
+	Only the arguments with an attack path to 'arg' can influence its acceptance, the rest of the reduct is dropped.
+	The remaining SCCs are processed in topological order (the SCCs are stored in reverse topological order): an SCC without initial
+	sets never gets one later, since only its own and upstream arguments determine its initial sets. So the first SCC that has
+	initial sets is the only one we branch on, every preferred extension can be serialised by adding the initial sets of the
+	upstream SCCs first. If no SCC has an initial set, base_ext + grounded is a preferred extension of the upstream part
+	that does not contain 'arg', i.e., a counterexample.
+	*/
+	vector<uint8_t> upstream = getUpstreamArguments(new_af, new_af.arg_to_int.find(arg)->second);
+	if (count(upstream.begin(), upstream.end(), 1) < new_af.args) {
+		new_af = getRestriction(new_af, upstream, atts);
 		#if defined(DEBUG_MODE)
-		log(thread_id, "SIGNAL --> TERM");
+		log(thread_id, "RESTRICTED TO UPSTREAM OF ARG");
+		#endif
+	}
+	const SCCs & sccs = new_af.sccs;
+
+	if (!explored_reducts.insert(fingerprint(getArgumentKeys(new_af)))) {
+		#if defined(DEBUG_MODE)
+		log(thread_id, "REDUCT ALREADY EXPLORED --> TERM");
 		#endif
 		return true;
 	}
 
-	// For each SCC, create a new thread to search for initial sets
-	for (size_t i = 0; i < sccs.size(); i++) {
+	for (uint32_t i = sccs.num_sccs(); i-- > 0; ) {
 		if (preferred_ce_found) {
 			#if defined(DEBUG_MODE)
 			log(thread_id, "SIGNAL --> TERM");
@@ -166,25 +229,197 @@ bool ds_preferred_r(const AF & af, string const & arg, vector<pair<string,string
 		// If SCC consists of only one argument, it won't have any initial set.
 		// If a SCC of size one has an initial set, it would be an unattacked initial set, 
 		// which cannot be since we accepted all unattacked initial sets via the grounded extension already.
-		if (sccs[i].size() == 1) {
+		if (sccs.scc_size(i) == 1) {
 			continue;
 		}
+		if (ds_preferred_r_scc(new_af, arg, atts, base_ext, sccs.get_scc(i))) {
+			#if defined(DEBUG_MODE)
+			log(thread_id, "BRANCHED ON FIRST SCC WITH INITIAL SETS --> TERM");
+			#endif
+			return true;
+		}
+	}
+	//====================================================================================================================================
 
+	if (preferred_ce_found) {
 		#if defined(DEBUG_MODE)
-		log(thread_id, "DETACHING TASK FOR SCC");
+		log(thread_id, "SIGNAL --> TERM");
 		#endif
-		vector<uint32_t> scc = sccs[i];
-		boost::asio::post(pool, [new_af, arg, &atts, base_ext, scc] {ds_preferred_r_scc(new_af, arg, atts, base_ext, scc);});
+		return true;
 	}
 
 	#if defined(DEBUG_MODE)
-	log(thread_id, "LOOPED ALL SCCS --> TERM");
+	log(thread_id, "NO SCC HAS INITIAL SETS, CURRENT EXT IS PREFERRED AND ARG NOT INCLUDED --> TERM NO");
 	#endif
+	found_counterexample();
+	return false;
+}
+
+/*
+Handles an initial set of an SCC: detects a counterexample or creates a new branch for the initial set and the respective reduct
+
+@returns 'false' if the initial set rejects 'arg', i.e., a counterexample has been found, 'true' otherwise
+*/
+static bool branch_on_initial_set(const AF & af, string const & arg, vector<pair<string,string>> & atts, const Branch & base_ext,
+		shared_ptr<const vector<string>> initial_set, unique_ptr<Heuristics::BranchScorer> & scorer) {
+	const vector<string> & extension = *initial_set;
+	#if defined(DEBUG_MODE)
+	int thread_id = thread_counter++;
+	#endif
+	// If 'arg' is in the initial set, the preferred extension accepts it and will never be a counterexample, 
+	// i.e., we continue without creating a thread for it
+	if (std::find(extension.begin(), extension.end(), arg) != extension.end()) {
+		#if defined(DEBUG_MODE)
+		log(thread_id, "MODEL ACCEPTS ARG --> SKIP");
+		#endif
+	} else {
+		// If there exists an attack from the initial set to 'arg', the model rejects arg, thus we found a counterexample
+		for(auto const& a: extension) {
+			if (af.att_exists.find(make_pair(af.arg_to_int.find(a)->second, af.arg_to_int.find(arg)->second)) != af.att_exists.end()) {
+				#if defined(DEBUG_MODE)
+				log(thread_id, "MODEL REJECTS ARG --> TERM NO");
+				#endif
+				found_counterexample();
+				return false;
+			}
+		}
+
+		// Check whether the current extension (base_ext + initial set) has already been checked by a different thread
+		Branch new_ext = base_ext.extend(move(initial_set));
+		if (!checked_branches.insert(new_ext.fingerprint())) {
+			#if defined(DEBUG_MODE)
+			log(thread_id, "BRANCH ALREADY CHECKED --> SKIP");
+			#endif
+		} else {
+			// The extension has not been checked before, that means a new thread can be created
+			#if defined(DEBUG_MODE)
+			log(thread_id, "DETACHING NEW TASK");
+			#endif
+			int64_t score = 0;
+			if (Heuristics::branch_order != SOLVER_ORDER) {
+				if (!scorer) {
+					scorer.reset(new Heuristics::BranchScorer(af, af.arg_to_int.find(arg)->second, new_ext.depth()));
+				}
+				vector<uint32_t> ids;
+				for (auto const& a: extension) {
+					ids.push_back(af.arg_to_int.find(a)->second);
+				}
+				score = scorer->score(ids);
+			}
+			post_branch(getReduct(af, extension, atts), arg, atts, new_ext, score);
+		}
+	}
 	return true;
 }
 
 /*
-helper function (threaded) for the DS-PR problem that searches for the initial sets of a SCC and creates new threads for each initial set found
+Searches the initial sets of a SCC with the incremental solver of the thread, like ds_preferred_r_scc
+The reduct is given by assumptions: arguments of the root framework that are not in 'af' are removed, the other arguments
+outside the SCC are not accepted. The clauses of this search are guarded by an activation literal, which is retired at the end.
+The minimisation restricts the next model to a subset of the last one by assumptions, and excludes the last model itself by a clause
+under the activation literal: every superset of that model contains the initial set found next, which is blocked anyway.
+Thus one search adds a single variable to the solver, however many SAT calls it makes.
+The same solver may be used by branches that are explored inline, so the state of the search is not kept in the solver's model.
+*/
+static bool search_scc_incremental(const AF & af, string const & arg, vector<pair<string,string>> & atts, const Branch & base_ext,
+		const vector<uint32_t> & scc, const Fingerprint & key, unique_ptr<Heuristics::BranchScorer> & scorer) {
+	RootSolver & root = root_solver();
+	SAT_Solver & solver = *root.solver;
+	const AF & root_af = *root_af_dspr;
+
+	vector<uint32_t> root_scc;
+	for (auto const& a: scc) {
+		root_scc.push_back(root_af.arg_to_int.find(af.int_to_arg[a])->second);
+	}
+	vector<uint8_t> status(root_af.args, 0);		// 1: argument of the reduct, 2: argument of the SCC
+	for (uint32_t i = 0; i < af.args; i++) {
+		status[root_af.arg_to_int.find(af.int_to_arg[i])->second] = 1;
+	}
+	for (auto const& a: root_scc) {
+		status[a] = 2;
+	}
+	vector<int> assumptions;
+	for (uint32_t i = 0; i < root_af.args; i++) {
+		if (status[i] == 0) {
+			assumptions.push_back(root.removed_var[i]);
+		} else {
+			assumptions.push_back(-root.removed_var[i]);
+			if (status[i] == 1) {
+				assumptions.push_back(-root_af.accepted_var[i]);
+			}
+		}
+	}
+	int activation = solver.new_var();
+	assumptions.push_back(activation);
+	vector<int> non_empty_clause = { -activation };
+	for (auto const& a: root_scc) {
+		non_empty_clause.push_back(root_af.accepted_var[a]);
+	}
+	solver.addClause(non_empty_clause);
+
+	vector<vector<string>> scc_extensions;
+	vector<uint32_t> members;
+	vector<int> subset_assumptions;
+	while (true) {
+		bool foundExt = false;
+		subset_assumptions = assumptions;
+		while (true) {
+			if (preferred_ce_found) {
+				return true;
+			}
+			int sat = solver.solve(subset_assumptions);
+			if (preferred_ce_found) {
+				return true;
+			}
+			if (sat == 20) break;
+
+			foundExt = true;
+			members.clear();
+			for (auto const& a: root_scc) {
+				if (solver.model[root_af.accepted_var[a]]) {
+					members.push_back(a);
+				}
+			}
+			if (members.size() == 1) {
+				break;
+			}
+
+			// look for a strict subset of the model within the SCC
+			vector<int> min_complement_clause = { -activation };
+			for (auto const& a: root_scc) {
+				if (solver.model[root_af.accepted_var[a]]) {
+					min_complement_clause.push_back(-root_af.accepted_var[a]);
+				} else {
+					subset_assumptions.push_back(-root_af.accepted_var[a]);
+				}
+			}
+			solver.addClause(min_complement_clause);
+		}
+		if (!foundExt) {
+			vector<int> retire_clause = { -activation };
+			solver.addClause(retire_clause);
+			bool initial_set_exists = !scc_extensions.empty();
+			cache_initial_sets(key, move(scc_extensions));
+			return initial_set_exists;
+		}
+
+		// block the initial set for the rest of this search
+		vector<int> complement_clause = { -activation };
+		vector<string> extension;
+		for (auto const& a: members) {
+			complement_clause.push_back(-root_af.accepted_var[a]);
+			extension.push_back(root_af.int_to_arg[a]);
+		}
+		solver.addClause(complement_clause);
+		scc_extensions.push_back(extension);
+		if (!branch_on_initial_set(af, arg, atts, base_ext, make_shared<const vector<string>>(move(extension)), scorer)) {
+			return true;
+		}
+	}
+}
+
+/*
+helper function for the DS-PR problem that searches for the initial sets of a SCC and creates new threads for each initial set found
 
 @param af		the argumentation framework
 @param arg		the argument to be decided
@@ -192,9 +427,9 @@ helper function (threaded) for the DS-PR problem that searches for the initial s
 @param base_ext	the current status of the extension that is constructed by this thread	
 @param scc		the SCC of AF that the search for initial sets should be restricted to
 
-@returns 'false' if the current extension is a counterexample for the skeptical acceptance of arg, 'true' if arg is accepted by the constructed extension
+@returns 'true' if the SCC has an initial set (or the search has been stopped), 'false' if it has none
 */
-bool ds_preferred_r_scc(const AF & af, std::string const & arg, std::vector<std::pair<std::string,std::string>> & atts, std::vector<std::string> base_ext, std::vector<uint32_t> scc) {
+bool ds_preferred_r_scc(const AF & af, std::string const & arg, std::vector<std::pair<std::string,std::string>> & atts, Branch base_ext, std::vector<uint32_t> scc) {
 	#if defined(DEBUG_MODE)
 	int thread_id = thread_counter++;
 	log(thread_id, "STARTING THREAD FOR SCC");
@@ -209,8 +444,53 @@ bool ds_preferred_r_scc(const AF & af, std::string const & arg, std::vector<std:
 		return true;
 	}
 
+	// Scores the branches created by this task, if a heuristic is used
+	unique_ptr<Heuristics::BranchScorer> scorer;
+
+	// The initial sets of an SCC that has been searched before (on another branch) are taken from the cache
+	Fingerprint key = getSCCContextFingerprint(af, af.sccs, af.sccs.component[scc[0]]);
+	InitialSetList cached;
+	if (scc_initial_sets.find(key, cached)) {
+		#if defined(DEBUG_MODE)
+		log(thread_id, "INITIAL SETS OF SCC CACHED");
+		#endif
+		for (size_t i = 0; i < cached->size(); i++) {
+			if (preferred_ce_found || !branch_on_initial_set(af, arg, atts, base_ext, shared_ptr<const vector<string>>(cached, &(*cached)[i]), scorer)) {
+				return true;
+			}
+		}
+		return !cached->empty();
+	}
+
+	// Cycles, symmetric and small SCCs are searched without a SAT solver
+	vector<vector<uint32_t>> small_initial_sets;
+	if (Structure::initial_sets(af, scc, small_initial_sets) || SmallSCC::initial_sets(af, scc, small_initial_sets)) {
+		shared_ptr<vector<vector<string>>> scc_extensions = make_shared<vector<vector<string>>>();
+		for (auto const& initial_set: small_initial_sets) {
+			vector<string> extension;
+			for (auto const& a: initial_set) {
+				extension.push_back(af.int_to_arg[a]);
+			}
+			scc_extensions->push_back(move(extension));
+		}
+		// the branches share the list with the cache
+		InitialSetList list = scc_extensions;
+		for (size_t i = 0; i < list->size(); i++) {
+			if (preferred_ce_found || !branch_on_initial_set(af, arg, atts, base_ext, shared_ptr<const vector<string>>(list, &(*list)[i]), scorer)) {
+				return true;
+			}
+		}
+		cache_initial_sets(key, list);
+		return !list->empty();
+	}
+
+	if (incremental_sat) {
+		return search_scc_incremental(af, arg, atts, base_ext, scc, key, scorer);
+	}
+
 	// Initializing the SAT solver and creating the encodings for initial sets
 	vector<string> extension;
+	vector<vector<string>> scc_extensions;
     vector<int> complement_clause;
     complement_clause.reserve(af.args);
 	SAT_Solver solver = SAT_Solver(af.count, af.solver_path);
@@ -296,63 +576,18 @@ bool ds_preferred_r_scc(const AF & af, std::string const & arg, std::vector<std:
 			log(thread_id, "MINIMAL MODEL", extension);
 			#endif
 
-			// If 'arg' is in the initial set, the preferred extension accepts it and will never be a counterexample, 
-			// i.e., we continue without creating a thread for it
-			if (std::find(extension.begin(), extension.end(), arg) != extension.end()) {
-				#if defined(DEBUG_MODE)
-				log(thread_id, "MODEL ACCEPTS ARG --> SKIP");
-				#endif
-			} else {
-				// If there exists an attack from the initial set to 'arg', the model rejects arg, thus we found a counterexample
-				for(auto const& a: extension) {
-					if (af.att_exists.find(make_pair(af.arg_to_int.find(a)->second, af.arg_to_int.find(arg)->second)) != af.att_exists.end()) {
-						#if defined(DEBUG_MODE)
-						log(thread_id, "MODEL REJECTS ARG --> TERM NO");
-						#endif
-						preferred_ce_found = true;
-						return false;
-					}
-				}
-
-				// Check whether the current extension (base_ext + initial set) has already been checked by a different thread
-				vector<string> new_ext;
-				set<string> branch;
-				for(auto const& a: base_ext) {
-					new_ext.push_back(a);
-					branch.insert(a);
-				}
-				for(auto const& a: extension) {
-					new_ext.push_back(a);
-					branch.insert(a);
-				}
-				mtx.lock();
-				bool already_checked = checked_branches.find(branch) != checked_branches.end();
-				mtx.unlock();
-				if (already_checked) {
-					#if defined(DEBUG_MODE)
-					log(thread_id, "BRANCH ALREADY CHECKED --> SKIP");
-					#endif
-				} else {
-					// The extension has not been checked before, that means a new thread can be created
-					mtx.lock();
-					checked_branches.insert(branch);
-					mtx.unlock();
-
-					#if defined(DEBUG_MODE)
-					log(thread_id, "DETACHING NEW TASK");
-					#endif
-					const AF reduct = getReduct(af, extension, atts);
-					boost::asio::post(pool, [reduct, arg, &atts, new_ext] {ds_preferred_r(reduct, arg, atts, new_ext);});
-				}
+			scc_extensions.push_back(extension);
+			if (!branch_on_initial_set(af, arg, atts, base_ext, make_shared<const vector<string>>(extension), scorer)) {
+				return true;
 			}
         } else {
 			// No further initial set has been found for the SCC
+			cache_initial_sets(key, move(scc_extensions));
 			if (no_initial_set_exists) {
-				// The SCC has no initial sets at all: base_ext is a preferred extension and since it does not contain 'arg' it is a counterexample
+				// The SCC has no initial sets at all, the search moves on to the next SCC
 				#if defined(DEBUG_MODE)
-				log(thread_id, "CURRENT EXT IS PREFERRED AND ARG NOT INCLUDED --> TERM NO");
+				log(thread_id, "SCC HAS NO INITIAL SETS --> TERM");
 				#endif
-				preferred_ce_found = true;
             	return false;
 			} else {
 				// The SCC has had at least one initial set: no definite decision possible yet, search continues in the created threads
@@ -391,14 +626,22 @@ Main method for solving the DS-PR problem
 */
 bool ds_preferred(const AF & af, string const & arg, vector<pair<string,string>> & atts) {
 	preferred_ce_found = false;
-
-	// Initialize search, starting with the empty set
-    vector<string> ext;
-	boost::asio::post(pool, [af, arg, &atts, ext] {ds_preferred_r(af, arg, atts, ext);});
+	root_af_dspr = make_shared<const AF>(af);
+	query_dspr++;
+	checked_branches.clear();
+	explored_reducts.clear();
+	scc_initial_sets.clear();
+
+	// Initialize search, starting with the empty set, SCCs and grounded labelling are computed once here and then updated with each reduct
+    Branch ext;
+	AF root_af = af;
+	computeStronglyConnectedComponents(root_af, root_af.sccs);
+	computeGroundedLabelling(root_af, root_af.grounded);
+	tasks_dspr.run([root_af, arg, &atts, ext] {ds_preferred_r(root_af, arg, atts, ext);});
 		
-	// Wait for all threads to finish and return result
-	// TODO Optimize pool destruction if counterexample has been found
-	pool.join();
+	// Wait for all tasks to finish and return result, after a counterexample only the running tasks have to return
+	tasks_dspr.wait();
+	branches_dspr.clear();
     return !preferred_ce_found;
 }
 
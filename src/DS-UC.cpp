@@ -1,12 +1,13 @@
 #include "Problems.h"					// Header for all Problem methods
 
-#include <algorithm>					// std::find
+#include <algorithm>					// std::find, std::sort
 #include <atomic>						// for tracking status of counterexample search
-#include <mutex>						// for checking duplicate thread creating
-#include <thread>						// std::thread::hardware_concurrency()
+#include <memory>						// std::unique_ptr
 
-#include <boost/asio/thread_pool.hpp>	// handles threads
-#include <boost/asio/post.hpp>			// for submitting tasks to thread pool
+#include "Fingerprint.h"				// for checking duplicate thread creating
+#include "Heuristics.h"					// for ordering the branches of the search
+#include "Scheduler.h"					// for submitting tasks to the shared scheduler
+#include "Structure.h"					// for answering acyclic reducts directly
 
 using namespace std;
 
@@ -14,16 +15,43 @@ using namespace std;
 std::atomic<bool> unchallenged_ce_found{false};
 
 // For preventing duplicate thread creation
-set<set<string>> checked_branches_dsuc;
-mutex mtx_dsuc;
+FingerprintSet checked_branches_dsuc;
 
-// Initializing thread pool
-int num_max_threads_dsuc = std::thread::hardware_concurrency()-1;
-boost::asio::thread_pool pool_dsuc(num_max_threads_dsuc);
+// Reducts whose search has been started, see explored_reducts in DS-PR
+FingerprintSet explored_reducts_dsuc;
 
+// Tasks of the current query
+TaskGroup tasks_dsuc;
+
+// Branches waiting to be explored, ordered by the selected heuristic
+Heuristics::BranchQueue<pair<AF,Branch>> branches_dsuc;
+
+
+// a counterexample decides the query: stop all other tasks
+static void found_counterexample() {
+	unchallenged_ce_found = true;
+	tasks_dsuc.cancel();
+}
 
 namespace Problems {
 
+bool ds_unchallenged_r(const AF & af, std::string const & arg, std::vector<std::pair<std::string,std::string>> & atts, Branch base_ext);
+
+// posts a task that explores the reduct of a new branch, see post_branch in DS-PR
+static void post_branch(const AF & reduct, string const & arg, vector<pair<string,string>> & atts, Branch ext, int64_t score) {
+	if (Heuristics::branch_order == SOLVER_ORDER) {
+		tasks_dsuc.run([reduct, arg, &atts, ext] {ds_unchallenged_r(reduct, arg, atts, ext);});
+		return;
+	}
+	branches_dsuc.push(make_pair(reduct, ext), score);
+	tasks_dsuc.run([arg, &atts] {
+		pair<AF,Branch> branch;
+		if (branches_dsuc.pop(branch)) {
+			ds_unchallenged_r(branch.first, arg, atts, branch.second);
+		}
+	});
+}
+
 /*
 helper function (threaded) for the DS-UC problem that recursively searches for a counterexample
 
@@ -34,13 +62,33 @@ helper function (threaded) for the DS-UC problem that recursively searches for a
 
 @returns 'false' if the current extension is a counterexample for the skeptical acceptance of arg, 'true' if arg is accepted by the constructed extension
 */
-bool ds_unchallenged_r(const AF & af, std::string const & arg, std::vector<std::pair<std::string,std::string>> & atts, std::vector<std::string> base_ext) {
+bool ds_unchallenged_r(const AF & af, std::string const & arg, std::vector<std::pair<std::string,std::string>> & atts, Branch base_ext) {
 	if (unchallenged_ce_found) {
 		return true;
 	}
+
+	// The blocked SCCs of the partial-order reduction restrict the search of the reduct, so they are part of the key
+	vector<uint64_t> keys = getArgumentKeys(af);
+	for (auto const& key: base_ext.blocked()) {
+		keys.push_back(~key);
+	}
+	if (!explored_reducts_dsuc.insert(fingerprint(keys))) {
+		return true;
+	}
 	
+	// Without cycles, the only extension that can still be reached adds the grounded extension of the reduct
+	if (af.sccs.is_computed() && af.grounded.is_computed() && Structure::is_acyclic(af, af.sccs)) {
+		auto it = af.arg_to_int.find(arg);
+		if (it == af.arg_to_int.end() || !af.grounded.is_in(it->second)) {
+			found_counterexample();
+			return false;
+		}
+		return true;
+	}
+
 	// Find all unattacked and unchallenged initial sets first
     set<vector<string>> ua_uc_initial_sets = get_ua_or_uc_initial(af);
+	unique_ptr<Heuristics::BranchScorer> scorer;
 
 	if (unchallenged_ce_found) {
 		return true;
@@ -48,12 +96,26 @@ bool ds_unchallenged_r(const AF & af, std::string const & arg, std::vector<std::
 
 	// If no unattacked/unchallenged initial set exists, base_ext is a counterexample for the skeptical acceptance of 'arg'
     if (ua_uc_initial_sets.empty()) {
-		unchallenged_ce_found = true;
+		found_counterexample();
         return false;
     }
     
+	// SCCs with initial sets, only these are blocked by the partial-order reduction
+	vector<uint8_t> has_initial_set(af.sccs.num_sccs(), 0);
+	for (const auto& ext : ua_uc_initial_sets) {
+		has_initial_set[af.sccs.component[af.arg_to_int.find(ext[0])->second]] = 1;
+	}
+	CommutingSCCs commuting(af, has_initial_set);
+
+	// The initial sets are shared by the new branches
+	InitialSetList initial_sets = make_shared<const vector<vector<string>>>(ua_uc_initial_sets.begin(), ua_uc_initial_sets.end());
+
+	// New branches with the key of the SCC of their initial set
+	vector<pair<uint64_t,size_t>> branches;
+
 	// For each unattacked or unchallenged initial set, check their relation to 'arg' and (if necessary) create a new thread for the respective reduct and initial set
-    for (const auto& ext : ua_uc_initial_sets) {
+    for (size_t i = 0; i < initial_sets->size(); i++) {
+		const vector<string> & ext = (*initial_sets)[i];
 		if (unchallenged_ce_found) {
 		return true;
 	}
@@ -64,34 +126,44 @@ bool ds_unchallenged_r(const AF & af, std::string const & arg, std::vector<std::
 		// If there exists an attack from the initial set to 'arg', the model rejects arg, thus we found a counterexample
 		for(auto const& a: ext) {
 			if (af.att_exists.find(make_pair(af.arg_to_int.find(a)->second, af.arg_to_int.find(arg)->second)) != af.att_exists.end()) {
-				unchallenged_ce_found = true;
+				found_counterexample();
 				return false;
 			}
 		}
 
-		// Check if a thread with the same extension has already been created
-		vector<string> new_ext;
-		set<string> branch;
-		for(auto const& a: base_ext) {
-			new_ext.push_back(a);
-			branch.insert(a);
-		}
-		for(auto const& a: ext) {
-			new_ext.push_back(a);
-			branch.insert(a);
+		// Initial sets that commute with the last added one have been added before it on another branch
+		uint32_t scc = af.sccs.component[af.arg_to_int.find(ext[0])->second];
+		if (base_ext.blocks_any() && base_ext.blocks(commuting.key(scc))) {
+			continue;
 		}
-		mtx_dsuc.lock();
-		bool already_checked = checked_branches_dsuc.find(branch) != checked_branches_dsuc.end();
-		mtx_dsuc.unlock();
+
+		branches.push_back(make_pair(commuting.key(scc), i));
+    }
+
+	// Branches are posted by decreasing SCC key, so the task of the smallest key runs first (see computeCommutingSCCs)
+	sort(branches.begin(), branches.end(), [](const pair<uint64_t,size_t> & a, const pair<uint64_t,size_t> & b) { return a.first > b.first; });
+	for (auto const& branch : branches) {
+		const vector<string> & ext = (*initial_sets)[branch.second];
+		uint32_t scc = af.sccs.component[af.arg_to_int.find(ext[0])->second];
+
+		// Check if a thread with the same extension has already been created
+		Branch new_ext = base_ext.extend(initial_sets, branch.second, commuting.get(scc));
 		// The extension has not been checked before, that means a new thread can be created
-		if (!already_checked) {
-			mtx_dsuc.lock();
-			checked_branches_dsuc.insert(branch);
-			mtx_dsuc.unlock();
-			const AF reduct = getReduct(af, ext, atts);
-			boost::asio::post(pool_dsuc, [reduct, arg, &atts, new_ext] {ds_unchallenged_r(reduct, arg, atts, new_ext);});
+		if (checked_branches_dsuc.insert(new_ext.search_fingerprint())) {
+			int64_t score = 0;
+			if (Heuristics::branch_order != SOLVER_ORDER) {
+				if (!scorer) {
+					scorer.reset(new Heuristics::BranchScorer(af, af.arg_to_int.find(arg)->second, new_ext.depth()));
+				}
+				vector<uint32_t> ids;
+				for (auto const& a: ext) {
+					ids.push_back(af.arg_to_int.find(a)->second);
+				}
+				score = scorer->score(ids);
+			}
+			post_branch(getReduct(af, ext, atts), arg, atts, new_ext, score);
 		}
-    }
+	}
     return true;
 }
 
@@ -106,11 +178,18 @@ Main method for solving the DS-UC problem
 */
 bool ds_unchallenged(const AF & af, string const & arg, std::vector<std::pair<std::string,std::string>> & atts) {
 	unchallenged_ce_found = false;
-    vector<string> ext;
-
-	boost::asio::post(pool_dsuc, [af, arg, &atts, ext] {ds_unchallenged_r(af, arg, atts, ext);});
-
-	pool_dsuc.join();
+	checked_branches_dsuc.clear();
+	explored_reducts_dsuc.clear();
+	scc_initial_sets.clear();
+    Branch ext;
+	AF root_af = af;
+	computeStronglyConnectedComponents(root_af, root_af.sccs);
+	computeGroundedLabelling(root_af, root_af.grounded);
+
+	tasks_dsuc.run([root_af, arg, &atts, ext] {ds_unchallenged_r(root_af, arg, atts, ext);});
+
+	tasks_dsuc.wait();
+	branches_dsuc.clear();
     return !unchallenged_ce_found;
 }
 
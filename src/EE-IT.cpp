@@ -1,175 +1,267 @@
 #include "Problems.h"
+#include "Scheduler.h"
+#include "SmallSCC.h"
+#include "Structure.h"
 
 using namespace std;
 
 namespace Problems {
 
-set<vector<string>> get_ua_or_uc_initial(const AF & af) {
-    set<vector<string> > extensions;
+FingerprintMap<InitialSetList> scc_initial_sets;
 
-    if (!af.args) {
-        return extensions;
+// an enumeration that has been interrupted by the cancellation of its task group is incomplete and must not be cached
+void cache_initial_sets(const Fingerprint & key, InitialSetList initial_sets) {
+    TaskGroup * group = TaskGroup::current();
+    if (group == NULL || !group->is_cancelled()) {
+        scc_initial_sets.insert(key, move(initial_sets));
     }
+}
+
+void cache_initial_sets(const Fingerprint & key, vector<vector<string>> initial_sets) {
+    cache_initial_sets(key, make_shared<const vector<vector<string>>>(move(initial_sets)));
+}
+
+// an SCC whose arguments are all attacked by the grounded extension has no initial set
+static bool all_out(const vector<uint32_t> & scc, const Labelling & grounded) {
+    for (auto const& arg: scc) {
+        if (!grounded.is_out(arg)) {
+            return false;
+        }
+    }
+    return true;
+}
 
-    vector<string> extension;
+/*
+Enumerates the initial sets of 'af' within 'scc' in the order the SAT solver returns them,
+SCCs of a special shape (see Structure) and small SCCs are searched without a solver
+Every SCC gets its own solver, so the SCCs of a framework can be enumerated in parallel.
+*/
+void enumerate_scc_initial_sets(const AF & af, const vector<uint32_t> & scc, const Labelling & grounded, vector<vector<uint32_t>> & initial_sets) {
+    if (Structure::initial_sets(af, scc, initial_sets) || SmallSCC::initial_sets(af, scc, initial_sets)) {
+        return;
+    }
+    vector<uint32_t> extension;
     vector<int> complement_clause;
     complement_clause.reserve(af.args);
-    vector<vector<uint32_t>> sccs = computeStronglyConnectedComponents(af);
-    for (auto const& scc: sccs) {
-        SAT_Solver solver = SAT_Solver(af.count, af.solver_path);
-        Encodings::add_admissible(af, solver);
-        Encodings::add_nonempty_subset_of(af, scc, solver);
+    SAT_Solver solver = SAT_Solver(af.count, af.solver_path);
+    Encodings::add_admissible(af, solver);
+    Encodings::add_nonempty_subset_of(af, scc, solver);
+    Encodings::add_grounded_out(af, grounded, solver);
 
+    while (true) {
+        bool foundExt = false;
         while (true) {
-            bool foundExt = false;
-            while (true) {
-                int sat = solver.solve();          
-                if (sat==20) break;
-                
-                foundExt = true;
-                extension.clear();
-                for (uint32_t i = 0; i < af.args; i++) {
-                    if (solver.model[af.accepted_var[i]]) {
-                        extension.push_back(af.int_to_arg[i]);
-                    }
-                }
+            int sat = solver.solve();
+            if (sat==20) break;
 
-                vector<int> min_complement_clause;
-                min_complement_clause.reserve(af.args);
-                for (uint32_t i = 0; i < af.args; i++) {
-                    if (solver.model[af.accepted_var[i]]) {
-                        min_complement_clause.push_back(-af.accepted_var[i]);
-                    } else {
-                        vector<int> unit_clause = { -af.accepted_var[i] };
-                        solver.addMinimizationClause(unit_clause);
-                    }
+            foundExt = true;
+            extension.clear();
+            for (uint32_t i = 0; i < af.args; i++) {
+                if (solver.model[af.accepted_var[i]]) {
+                    extension.push_back(i);
                 }
-                solver.addMinimizationClause(min_complement_clause);
-            }
-            if (foundExt) {
-                extensions.insert(extension);
-            } else {
-                break;
             }
 
-            complement_clause.clear();
+            vector<int> min_complement_clause;
+            min_complement_clause.reserve(af.args);
             for (uint32_t i = 0; i < af.args; i++) {
                 if (solver.model[af.accepted_var[i]]) {
-                    complement_clause.push_back(-af.accepted_var[i]);
+                    min_complement_clause.push_back(-af.accepted_var[i]);
                 } else {
-                    //complement_clause.push_back(-af.rejected_var[i]);
+                    vector<int> unit_clause = { -af.accepted_var[i] };
+                    solver.addMinimizationClause(unit_clause);
                 }
             }
-            solver.addClause(complement_clause);
+            solver.addMinimizationClause(min_complement_clause);
+        }
+        if (foundExt) {
+            initial_sets.push_back(extension);
+        } else {
+            break;
         }
-        solver.free();
-	}
-
 
-    // filter out the challenged initial sets
-    // TODO can maybe be optimized
-    std::set<vector<string> > result;
-    for (auto ext1: extensions) {
-        bool challenged = false;
-        for (auto ext2: extensions) {
-            if (ext1 == ext2) {
-                continue;
-            }
-            for (auto arg1: ext1) {
-                for (auto arg2: ext2) {
-                    try {
-                        u_int32_t arg1_id = af.arg_to_int.find(arg1)->second;
-                        u_int32_t arg2_id = af.arg_to_int.find(arg2)->second;
-                        if (af.att_exists.at(make_pair(arg1_id, arg2_id)) || af.att_exists.at(make_pair(arg2_id, arg1_id))) {
-                            challenged = true;
-                            break;
-                        }
-                    }
-                    catch(const std::exception& e) {
-                        ;
-                    } 
-                }
-                if (challenged) {
-                    break;
-                }
-            }
-            if (challenged) {
-                break;
+        complement_clause.clear();
+        for (uint32_t i = 0; i < af.args; i++) {
+            if (solver.model[af.accepted_var[i]]) {
+                complement_clause.push_back(-af.accepted_var[i]);
             }
         }
-        if (!challenged) {
-            result.insert(ext1);
-        } 
+        solver.addClause(complement_clause);
     }
+    solver.free();
+}
 
-	return result;
+/*
+Executes fn(k) for k = 0..n-1, the k-th SCC that needs a SAT enumeration
+Each call encodes the whole framework, so the calls are posted as tasks of a group nested in the current task
+(cancelled together with it) unless there is only one of them or the framework is below the granularity thresholds.
+*/
+void for_each_scc_enumeration(const AF & af, uint32_t n, const function<void(uint32_t)> & fn) {
+    uint64_t attacks = 0;
+    for (auto const& attackers: af.attackers) {
+        attacks += attackers.size();
+    }
+    if (n < 2 || Scheduler::instance().num_threads() < 2 || !Granularity::spawn(af.args, attacks)) {
+        for (uint32_t k = 0; k < n; k++) {
+            fn(k);
+        }
+        return;
+    }
+    TaskGroup tasks(TaskGroup::current());
+    for (uint32_t k = 0; k < n; k++) {
+        tasks.run([&fn, k] { fn(k); });
+    }
+    tasks.wait();
 }
 
-bool ee_initial(const AF & af) {
-    std::cout << "[";
+set<vector<string>> get_ua_or_uc_initial(const AF & af) {
+    set<vector<string> > extensions;
 
-    int count = 0;
-    vector<uint32_t> extension;
-    vector<int> complement_clause;
-    complement_clause.reserve(af.args);
-    
     if (!af.args) {
-        std::cout << "]\n";
-        return true;
+        return extensions;
     }
 
-    vector<vector<uint32_t>> sccs = computeStronglyConnectedComponents(af);
-    for (auto const& scc: sccs) {
-        SAT_Solver solver = SAT_Solver(af.count, af.solver_path);
-        Encodings::add_admissible(af, solver);
-        Encodings::add_nonempty_subset_of(af, scc, solver);
+    // reducts carry their SCCs over from the parent, only compute them if they are not known yet
+    SCCs computed_sccs;
+    if (!af.sccs.is_computed()) {
+        computeStronglyConnectedComponents(af, computed_sccs);
+    }
+    const SCCs & sccs = af.sccs.is_computed() ? af.sccs : computed_sccs;
+    // the same holds for the grounded labelling
+    Labelling computed_grounded;
+    if (!af.grounded.is_computed()) {
+        computeGroundedLabelling(af, computed_grounded);
+    }
+    const Labelling & grounded = af.grounded.is_computed() ? af.grounded : computed_grounded;
 
-        while (true) {
-            bool foundExt = false;
-            while (true) {
-                int sat = solver.solve();          
-                if (sat==20) break;
-                
-                foundExt = true;
-                extension.clear();
-                for (uint32_t i = 0; i < af.args; i++) {
-                    if (solver.model[af.accepted_var[i]]) {
-                        extension.push_back(i);
-                    }
-                }
+    // SCCs whose initial sets are neither trivial nor cached, with their cache keys
+    vector<uint32_t> pending;
+    vector<Fingerprint> keys;
+    for (uint32_t i = 0; i < sccs.num_sccs(); i++) {
+        vector<uint32_t> scc = sccs.get_scc(i);
+        // unattacked arguments are exactly the unattacked initial sets
+        if (scc.size() == 1 && af.unattacked[scc[0]]) {
+            extensions.insert(vector<string>(1, af.int_to_arg[scc[0]]));
+            continue;
+        }
+        if (all_out(scc, grounded)) {
+            continue;
+        }
+        // the initial sets of an SCC only depend on its arguments and which of them are attacked from outside
+        Fingerprint key = getSCCContextFingerprint(af, sccs, i);
+        InitialSetList cached;
+        if (scc_initial_sets.find(key, cached)) {
+            extensions.insert(cached->begin(), cached->end());
+            continue;
+        }
+        pending.push_back(i);
+        keys.push_back(key);
+    }
 
-                vector<int> min_complement_clause;
-                min_complement_clause.reserve(af.args);
-                for (uint32_t i = 0; i < af.args; i++) {
-                    if (solver.model[af.accepted_var[i]]) {
-                        min_complement_clause.push_back(-af.accepted_var[i]);
-                    } else {
-                        vector<int> unit_clause = { -af.accepted_var[i] };
-                        solver.addMinimizationClause(unit_clause);
-                    }
-                }
-                solver.addMinimizationClause(min_complement_clause);
+    vector<vector<vector<string>>> scc_extensions(pending.size());
+    for_each_scc_enumeration(af, pending.size(), [&](uint32_t k) {
+        vector<vector<uint32_t>> initial_sets;
+        enumerate_scc_initial_sets(af, sccs.get_scc(pending[k]), grounded, initial_sets);
+        for (auto const& initial_set: initial_sets) {
+            vector<string> extension;
+            extension.reserve(initial_set.size());
+            for (auto const& arg: initial_set) {
+                extension.push_back(af.int_to_arg[arg]);
             }
-            if (foundExt) {
-                if (!count++ == 0) {
+            scc_extensions[k].push_back(move(extension));
+        }
+        cache_initial_sets(keys[k], scc_extensions[k]);
+    });
+    for (auto const& initial_sets: scc_extensions) {
+        extensions.insert(initial_sets.begin(), initial_sets.end());
+    }
+
+    // filter out the challenged initial sets
+    vector<vector<uint32_t>> ids;
+    ids.reserve(extensions.size());
+    for (auto const& ext: extensions) {
+        vector<uint32_t> set_ids;
+        set_ids.reserve(ext.size());
+        for (auto const& arg: ext) {
+            set_ids.push_back(af.arg_to_int.find(arg)->second);
+        }
+        ids.push_back(move(set_ids));
+    }
+    vector<vector<uint32_t>> challenges = getChallengeGraph(af, ids);
+    std::set<vector<string> > result;
+    uint32_t i = 0;
+    for (auto const& ext: extensions) {
+        if (challenges[i++].empty()) {
+            result.insert(result.end(), ext);
+        }
+    }
+
+	return result;
+}
+
+/*
+Output of EE-IT in SCC order while the SCCs are enumerated in parallel
+The initial sets of an SCC are printed as soon as those of all earlier SCCs have been, by the task that completes this prefix.
+*/
+class OrderedPrinter {
+public:
+    OrderedPrinter(const AF & af, uint32_t num_sccs) : af(af), initial_sets(num_sccs), done(num_sccs, 0), next(0), count(0) {}
+
+    void complete(uint32_t scc, vector<vector<uint32_t>> scc_initial_sets) {
+        lock_guard<mutex> lock(mtx);
+        initial_sets[scc] = move(scc_initial_sets);
+        done[scc] = 1;
+        while (next < done.size() && done[next]) {
+            for (auto const& extension: initial_sets[next]) {
+                if (count++ > 0) {
                     std::cout << ", ";
                 }
                 print_extension_ee(af, extension);
-            } else {
-                break;
             }
+            vector<vector<uint32_t>>().swap(initial_sets[next]);
+            next++;
+        }
+    }
 
-            complement_clause.clear();
-            for (uint32_t i = 0; i < af.args; i++) {
-                if (solver.model[af.accepted_var[i]]) {
-                    complement_clause.push_back(-af.accepted_var[i]);
-                } else {
-                    //complement_clause.push_back(-af.rejected_var[i]);
-                }
-            }
-            solver.addClause(complement_clause);       
+private:
+    const AF & af;
+    mutex mtx;
+    vector<vector<vector<uint32_t>>> initial_sets;
+    vector<uint8_t> done;
+    uint32_t next;
+    uint64_t count;
+};
+
+bool ee_initial(const AF & af) {
+    std::cout << "[";
+
+    if (!af.args) {
+        std::cout << "]\n";
+        return true;
+    }
+
+    SCCs sccs;
+    computeStronglyConnectedComponents(af, sccs);
+    Labelling grounded;
+    computeGroundedLabelling(af, grounded);
+    OrderedPrinter printer(af, sccs.num_sccs());
+    vector<uint32_t> pending;
+    for (uint32_t i = 0; i < sccs.num_sccs(); i++) {
+        vector<uint32_t> scc = sccs.get_scc(i);
+        // unattacked arguments are exactly the unattacked initial sets
+        if (scc.size() == 1 && af.unattacked[scc[0]]) {
+            printer.complete(i, vector<vector<uint32_t>>(1, scc));
+        } else if (all_out(scc, grounded)) {
+            printer.complete(i, vector<vector<uint32_t>>());
+        } else {
+            pending.push_back(i);
         }
-	}
+    }
+    for_each_scc_enumeration(af, pending.size(), [&](uint32_t k) {
+        vector<vector<uint32_t>> initial_sets;
+        enumerate_scc_initial_sets(af, sccs.get_scc(pending[k]), grounded, initial_sets);
+        printer.complete(pending[k], move(initial_sets));
+    });
     std::cout << "]\n";
 	return true;
 }
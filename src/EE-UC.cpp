@@ -1,77 +1,149 @@
 #include "Problems.h"					// Header for all Problem methods
 
 #include <algorithm>                    // std::find
-#include <mutex>                        // for checking duplicate thread creating
-#include <thread>						// std::thread::hardware_concurrency()
+#include <mutex>                        // for synchronizing the output
+#include <unordered_set>                // for preventing duplicate output
 
-#include <boost/asio/thread_pool.hpp>	// handles threads
-#include <boost/asio/post.hpp>			// for submitting tasks to thread pool
+#include "Fingerprint.h"				// for preventing duplicate threads
+#include "Scheduler.h"					// for submitting tasks to the shared scheduler
+#include "Structure.h"					// for completing acyclic reducts directly
 
 using namespace std;
 
 // Variables for preventing duplicate threads
-set<set<string>> checked_branches_eeuc;
-mutex mtx_eeuc;
+FingerprintSet checked_branches_eeuc;
 
-// Lock for synchronizing output of extensions
-mutex stdout_lock_eeuc;
-
-// Initialize thread pool
-auto num_max_threads_eeuc = std::thread::hardware_concurrency()-1;
-boost::asio::thread_pool pool_eeuc(num_max_threads_eeuc);
+// Tasks of the current query
+TaskGroup tasks_eeuc;
 
 
 namespace Problems {
 
+/*
+Extensions of one weakly connected component of the framework
+With a single component they are printed as soon as they are found, otherwise they are collected for the product over all components.
+With the partial-order reduction, an extension can be reached on branches that differ in their blocked SCCs, it is only taken once.
+*/
+struct ComponentExtensions {
+    ComponentExtensions(bool print) : print(print) {}
+
+    void add(const Branch & ext) {
+        lock_guard<mutex> lock(mtx);
+        if (!seen.insert(ext.fingerprint()).second) {
+            return;
+        }
+        if (print) {
+            print_extension_ee(ext.arguments());
+        } else {
+            extensions.push_back(ext.arguments());
+        }
+    }
+
+    bool print;
+    mutex mtx;
+    unordered_set<Fingerprint,FingerprintHash> seen;
+    vector<vector<string>> extensions;
+};
+
 /*
 Helper function for recursive (threaded) construction of unchallenged extensions
 
 @param af		the argumentation framework
 @param atts		list of all attacks of the AF (only for faster reduct construction)
 @param base_ext	the current status of the extension that is constructed by this thread
+@param leaves	receives the extension, if the termination criterion is met
 
-@returns 'true'; also prints the extension, if the termination criterion is met
+@returns 'true'
 */
-bool ee_unchallenged_r(const AF & af, std::vector<std::pair<std::string,std::string>> & atts, vector<string> base_ext) {
-    set<vector<string>> ua_uc_initial_sets = get_ua_or_uc_initial(af);
+bool ee_unchallenged_r(const AF & af, std::vector<std::pair<std::string,std::string>> & atts, Branch base_ext, ComponentExtensions & leaves) {
+    // without cycles, serialising the remaining initial sets in any order adds exactly the grounded extension of the reduct
+    set<vector<string>> ua_uc_initial_sets;
+    if (af.sccs.is_computed() && af.grounded.is_computed() && Structure::is_acyclic(af, af.sccs)) {
+        shared_ptr<vector<string>> grounded = make_shared<vector<string>>();
+        for (auto const& a: getGroundedExtension(af, af.grounded)) {
+            grounded->push_back(af.int_to_arg[a]);
+        }
+        if (!grounded->empty()) {
+            base_ext = base_ext.extend(grounded);
+        }
+    } else {
+        ua_uc_initial_sets = get_ua_or_uc_initial(af);
+    }
 
     if (ua_uc_initial_sets.empty()) {
-        stdout_lock_eeuc.lock();
-        print_extension_ee(base_ext);
-        stdout_lock_eeuc.unlock();
+        leaves.add(base_ext);
         return true;
     }
     
+    vector<uint8_t> has_initial_set(af.sccs.num_sccs(), 0);
     for (const auto& ext : ua_uc_initial_sets) {
-        vector<string> new_ext;
-        set<string> branch;
-        for(auto const& arg: base_ext) {
-            new_ext.push_back(arg);
-            branch.insert(arg);
-        }
-        for(auto const& arg: ext) {
-            new_ext.push_back(arg);
-            branch.insert(arg);
+        has_initial_set[af.sccs.component[af.arg_to_int.find(ext[0])->second]] = 1;
+    }
+    CommutingSCCs commuting(af, has_initial_set);
+    InitialSetList initial_sets = make_shared<const vector<vector<string>>>(ua_uc_initial_sets.begin(), ua_uc_initial_sets.end());
+    for (size_t i = 0; i < initial_sets->size(); i++) {
+        const vector<string> & ext = (*initial_sets)[i];
+        // initial sets that commute with the last added one have been added before it on another branch
+        uint32_t scc = af.sccs.component[af.arg_to_int.find(ext[0])->second];
+        if (base_ext.blocks_any() && base_ext.blocks(commuting.key(scc))) {
+            continue;
         }
-        
-        mtx_eeuc.lock();
-        bool already_checked = checked_branches_eeuc.find(branch) != checked_branches_eeuc.end();
-        mtx_eeuc.unlock();
-        if (!already_checked) {
-            mtx_eeuc.lock();
-            checked_branches_eeuc.insert(branch);
-            mtx_eeuc.unlock();
+        Branch new_ext = base_ext.extend(initial_sets, i, commuting.get(scc));
+        if (checked_branches_eeuc.insert(new_ext.search_fingerprint())) {
             const AF reduct = getReduct(af, ext, atts);
-            boost::asio::post(pool_eeuc, [reduct, &atts, new_ext] { ee_unchallenged_r(reduct, atts, new_ext); });
+            tasks_eeuc.run([reduct, &atts, new_ext, &leaves] { ee_unchallenged_r(reduct, atts, new_ext, leaves); });
         }
         
     }
     return true;
 }
 
+// framework of the arguments 'args' of 'af' with the attacks 'atts' among them, built in time linear in the size of the component
+static AF getComponent(const AF & af, const vector<uint32_t> & args, const vector<pair<string,string>> & atts) {
+    AF component = AF();
+    component.sem = af.sem;
+    for (auto const& arg: args) {
+        component.add_argument(af.int_to_arg[arg]);
+    }
+    component.initialize_attackers();
+    for (auto const& att: atts) {
+        component.add_attack(att);
+    }
+    component.initialize_vars();
+    component.set_solver_path(af.solver_path);
+    return component;
+}
+
+/*
+Prints the union of one extension of each component for all combinations, without materialising the product
+*/
+static void print_product(const vector<unique_ptr<ComponentExtensions>> & components) {
+    vector<size_t> choice(components.size(), 0);
+    while (true) {
+        vector<string> extension;
+        for (size_t c = 0; c < components.size(); c++) {
+            const vector<string> & part = components[c]->extensions[choice[c]];
+            extension.insert(extension.end(), part.begin(), part.end());
+        }
+        print_extension_ee(extension);
+
+        size_t c = 0;
+        while (c < components.size() && ++choice[c] == components[c]->extensions.size()) {
+            choice[c++] = 0;
+        }
+        if (c == components.size()) {
+            return;
+        }
+    }
+}
+
 /*
 Main function for the EE-UC problem, starts the iterative construction with the empty set
 
+Initial sets, challenges and reducts never reach across weakly connected components, so the unchallenged extensions of a disconnected
+framework are exactly the unions of one unchallenged extension per component. The components are searched independently (and in parallel),
+so the work is the sum of their searches rather than that of a joint search over all interleavings, and the product is printed at the end.
+
 @param af		the argumentation framework
 @param atts		list of all attacks of the AF (only for faster reduct construction)
 
@@ -79,11 +151,51 @@ Main function for the EE-UC problem, starts the iterative construction with the
 */
 bool ee_unchallenged(const AF & af, vector<pair<string,string>> & atts) {
     std::cout << "[";
-    
-    vector<string> ext;
-    boost::asio::post(pool_eeuc, [af, &atts, ext] { ee_unchallenged_r(af, atts, ext); });
-    
-    pool_eeuc.join();
+    checked_branches_eeuc.clear();
+
+    Branch ext;
+    vector<uint32_t> wcc;
+    uint32_t num_components = computeWeaklyConnectedComponents(af, wcc);
+    if (num_components < 2) {
+        AF root_af = af;
+        computeStronglyConnectedComponents(root_af, root_af.sccs);
+        computeGroundedLabelling(root_af, root_af.grounded);
+        ComponentExtensions leaves(true);
+        tasks_eeuc.run([root_af, &atts, ext, &leaves] { ee_unchallenged_r(root_af, atts, ext, leaves); });
+        tasks_eeuc.wait();
+        std::cout << "]\n";
+        return true;
+    }
+
+    vector<vector<uint32_t>> component_args(num_components);
+    for (uint32_t i = 0; i < af.args; i++) {
+        component_args[wcc[i]].push_back(i);
+    }
+    vector<vector<pair<string,string>>> component_atts(num_components);
+    for (auto const& att: atts) {
+        auto source = af.arg_to_int.find(att.first);
+        if (source != af.arg_to_int.end() && af.arg_to_int.count(att.second)) {
+            component_atts[wcc[source->second]].push_back(att);
+        }
+    }
+    vector<unique_ptr<ComponentExtensions>> components;
+    for (uint32_t c = 0; c < num_components; c++) {
+        components.push_back(unique_ptr<ComponentExtensions>(new ComponentExtensions(false)));
+    }
+    for (uint32_t c = 0; c < num_components; c++) {
+        ComponentExtensions & leaves = *components[c];
+        vector<pair<string,string>> & comp_atts = component_atts[c];
+        const vector<uint32_t> & args = component_args[c];
+        tasks_eeuc.run([&af, &args, &comp_atts, ext, &leaves] {
+            AF root_af = getComponent(af, args, comp_atts);
+            computeStronglyConnectedComponents(root_af, root_af.sccs);
+            computeGroundedLabelling(root_af, root_af.grounded);
+            ee_unchallenged_r(root_af, comp_atts, ext, leaves);
+        });
+    }
+    tasks_eeuc.wait();
+
+    print_product(components);
     std::cout << "]\n";
     return true;
 }
@@ -28,6 +28,16 @@ void add_nonempty_subset_of(const AF & af, vector<uint32_t> args, SAT_Solver & s
 	}
 }
 
+// arguments attacked by the grounded extension are not contained in any admissible set
+void add_grounded_out(const AF & af, const Labelling & grounded, SAT_Solver & solver) {
+	for (uint32_t i = 0; i < af.args; i++) {
+		if (grounded.is_out(i)) {
+			vector<int> unit_clause = { -af.accepted_var[i] };
+			solver.addClause(unit_clause);
+		}
+	}
+}
+
 /*!
  * The following is largely taken from the mu-toksia solver
  * and is subject to the following licence.
@@ -104,6 +114,26 @@ void add_admissible(const AF & af, SAT_Solver & solver) {
 	}
 }
 
+/*
+Admissible sets of the subframeworks of af (e.g. reducts): an argument i is removed from the framework by assuming removed_var[i],
+removed arguments are not accepted and do not have to be defended against.
+Under the assumptions for a reduct, the models are exactly the admissible sets of the reduct, so one solver for af serves all its reducts.
+*/
+void add_admissible_in_reducts(const AF & af, const vector<int> & removed_var, SAT_Solver & solver) {
+	add_conflict_free(af, solver);
+	add_rejected_clauses(af, solver);
+	for (uint32_t i = 0; i < af.args; i++) {
+		vector<int> removed_clause = { -removed_var[i], -af.accepted_var[i] };
+		solver.addClause(removed_clause);
+		if (af.self_attack[i]) continue;
+		for (uint32_t j = 0; j < af.attackers[i].size(); j++) {
+			if (af.symmetric_attack.at(make_pair(af.attackers[i][j], i))) continue;
+			vector<int> clause = { -af.accepted_var[i], af.rejected_var[af.attackers[i][j]], removed_var[af.attackers[i][j]] };
+			solver.addClause(clause);
+		}
+	}
+}
+
 void add_complete(const AF & af, SAT_Solver & solver)
 {
 	add_admissible(af, solver);
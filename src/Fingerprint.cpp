@@ -0,0 +1,83 @@
+#include "Fingerprint.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// finaliser of splitmix64
+static uint64_t mix(uint64_t x) {
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return x;
+}
+
+uint64_t argument_key(const string & arg) {
+	// FNV-1a, independent of the standard library implementation
+	uint64_t h = 0xcbf29ce484222325ULL;
+	for (auto const& c: arg) {
+		h ^= (unsigned char) c;
+		h *= 0x100000001b3ULL;
+	}
+	return mix(h);
+}
+
+Fingerprint fingerprint(vector<uint64_t> keys) {
+	sort(keys.begin(), keys.end());
+	Fingerprint fp;
+	fp.lo = 0x9e3779b97f4a7c15ULL ^ keys.size();
+	fp.hi = 0x6a09e667f3bcc909ULL + keys.size();
+	for (auto const& k: keys) {
+		fp.lo = mix(fp.lo ^ k);
+		fp.hi = mix(fp.hi + (k ^ 0xd1b54a32d192ed03ULL));
+	}
+	// the all-zero fingerprint marks free slots
+	if (fp.empty()) {
+		fp.lo = 1;
+	}
+	return fp;
+}
+
+bool FingerprintSet::insert(const Fingerprint & fp) {
+	Shard & shard = shards[fp.hi % NUM_SHARDS];
+	lock_guard<mutex> lock(shard.mtx);
+
+	// keep the load factor below 1/2
+	if (2 * (shard.count + 1) > shard.table.size()) {
+		vector<Fingerprint> old(max<size_t>(64, 2 * shard.table.size()));
+		old.swap(shard.table);
+		size_t mask = shard.table.size() - 1;
+		for (auto const& entry: old) {
+			if (entry.empty()) {
+				continue;
+			}
+			size_t slot = entry.lo & mask;
+			while (!shard.table[slot].empty()) {
+				slot = (slot + 1) & mask;
+			}
+			shard.table[slot] = entry;
+		}
+	}
+
+	size_t mask = shard.table.size() - 1;
+	size_t slot = fp.lo & mask;
+	while (!shard.table[slot].empty()) {
+		if (shard.table[slot] == fp) {
+			return false;
+		}
+		slot = (slot + 1) & mask;
+	}
+	shard.table[slot] = fp;
+	shard.count++;
+	return true;
+}
+
+void FingerprintSet::clear() {
+	for (auto & shard: shards) {
+		lock_guard<mutex> lock(shard.mtx);
+		shard.table.clear();
+		shard.count = 0;
+	}
+}
@@ -0,0 +1,235 @@
+#include "Util.h"
+
+#include "Scheduler.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// minimum number of arguments for computing the grounded labelling in parallel
+#ifndef PARALLEL_GROUNDED_THRESHOLD
+#define PARALLEL_GROUNDED_THRESHOLD 1000000
+#endif
+
+// frontiers smaller than this are processed by a single thread
+#ifndef PARALLEL_GROUNDED_GRAIN
+#define PARALLEL_GROUNDED_GRAIN 4096
+#endif
+
+using namespace std;
+
+/*
+ * The propagation of the grounded labelling is adapted from the fudge argumentation-solver
+ * and is subject to the GPL3 licence.
+*/
+
+static void reset_labelling(uint32_t args, Labelling & lab) {
+	lab.computed = true;
+	lab.in.assign((args + 63) / 64, 0);
+	lab.out.assign((args + 63) / 64, 0);
+	lab.num_attackers.resize(args);
+}
+
+// labels everything attacked by the arguments on the stack out, and every argument whose attackers are all out in
+static void propagate(const AF & af, Labelling & lab, vector<uint32_t> & arg_stack) {
+	while (!arg_stack.empty()) {
+		uint32_t arg = arg_stack.back();
+		arg_stack.pop_back();
+		for (auto const& arg1: af.attacked[arg]) {
+			if (lab.is_out(arg1)) {
+				continue;
+			}
+			lab.set_out(arg1);
+			for (auto const& arg2: af.attacked[arg1]) {
+				if (lab.is_undec(arg2) && lab.num_attackers[arg2] > 0) {
+					lab.num_attackers[arg2]--;
+					if (lab.num_attackers[arg2] == 0) {
+						lab.set_in(arg2);
+						arg_stack.push_back(arg2);
+					}
+				}
+			}
+		}
+	}
+}
+
+// computes the grounded labelling of af from scratch, very large frameworks are labelled in parallel
+void computeGroundedLabelling(const AF & af, Labelling & lab) {
+	if (af.args >= PARALLEL_GROUNDED_THRESHOLD && Scheduler::instance().num_threads() > 1) {
+		computeGroundedLabellingParallel(af, lab, Scheduler::instance().num_threads());
+		return;
+	}
+	reset_labelling(af.args, lab);
+	vector<uint32_t> arg_stack;
+	for (uint32_t i = 0; i < af.args; i++) {
+		lab.num_attackers[i] = af.attackers[i].size();
+		if (af.unattacked[i]) {
+			lab.set_in(i);
+			arg_stack.push_back(i);
+		}
+	}
+	propagate(af, lab, arg_stack);
+}
+
+// executes fn(t) for t = 0..num_threads-1 on the shared scheduler and waits for all of them
+static void run_on_threads(uint32_t num_threads, const function<void(uint32_t)> & fn) {
+	TaskGroup group;
+	for (uint32_t t = 0; t < num_threads; t++) {
+		group.run([&fn, t] { fn(t); });
+	}
+	group.wait();
+}
+
+/*
+Level-synchronous parallel computation of the grounded labelling
+Each round processes the current frontier of in arguments in parallel: the arguments they attack are labelled out
+(claimed with an atomic exchange), and the attacker counters of the arguments attacked by those are decremented atomically.
+Arguments whose counter reaches zero are labelled in and form the next frontier. The result is the same as computeGroundedLabelling.
+*/
+void computeGroundedLabellingParallel(const AF & af, Labelling & lab, uint32_t num_threads) {
+	const uint8_t UNDEC = 0, IN = 1, OUT = 2;
+	const uint32_t chunk_size = 256;
+	uint32_t threads = max(num_threads, 1u);
+
+	unique_ptr<atomic<uint8_t>[]> state(new atomic<uint8_t>[af.args]);
+	unique_ptr<atomic<uint32_t>[]> counter(new atomic<uint32_t>[af.args]);
+	vector<vector<uint32_t>> next(threads);
+	vector<uint32_t> frontier;
+
+	// initial counters, the unattacked arguments form the first frontier
+	uint32_t per_thread = (af.args + threads - 1) / threads;
+	run_on_threads(threads, [&](uint32_t t) {
+		uint32_t end = min(af.args, (t + 1) * per_thread);
+		for (uint32_t i = t * per_thread; i < end; i++) {
+			counter[i].store(af.attackers[i].size(), memory_order_relaxed);
+			state[i].store(af.unattacked[i] ? IN : UNDEC, memory_order_relaxed);
+			if (af.unattacked[i]) {
+				next[t].push_back(i);
+			}
+		}
+	});
+
+	auto process = [&](uint32_t arg, vector<uint32_t> & out) {
+		for (auto const& arg1: af.attacked[arg]) {
+			uint8_t expected = UNDEC;
+			if (state[arg1].load(memory_order_relaxed) != UNDEC || !state[arg1].compare_exchange_strong(expected, OUT)) {
+				continue;
+			}
+			for (auto const& arg2: af.attacked[arg1]) {
+				if (counter[arg2].fetch_sub(1) == 1) {
+					uint8_t undec = UNDEC;
+					if (state[arg2].compare_exchange_strong(undec, IN)) {
+						out.push_back(arg2);
+					}
+				}
+			}
+		}
+	};
+
+	atomic<size_t> next_index(0);
+	while (true) {
+		frontier.clear();
+		for (auto & n: next) {
+			frontier.insert(frontier.end(), n.begin(), n.end());
+			n.clear();
+		}
+		if (frontier.empty()) {
+			break;
+		}
+		if (frontier.size() < PARALLEL_GROUNDED_GRAIN) {
+			for (auto const& arg: frontier) {
+				process(arg, next[0]);
+			}
+			continue;
+		}
+		next_index = 0;
+		run_on_threads(threads, [&](uint32_t t) {
+			size_t begin;
+			while ((begin = next_index.fetch_add(chunk_size)) < frontier.size()) {
+				size_t end = min(frontier.size(), begin + chunk_size);
+				for (size_t i = begin; i < end; i++) {
+					process(frontier[i], next[t]);
+				}
+			}
+		});
+	}
+
+	// convert into bitsets, every thread fills whole words
+	reset_labelling(af.args, lab);
+	uint32_t words = lab.in.size();
+	uint32_t words_per_thread = (words + threads - 1) / threads;
+	run_on_threads(threads, [&](uint32_t t) {
+		uint32_t end = min(af.args, min(words, (t + 1) * words_per_thread) * 64);
+		for (uint32_t i = t * words_per_thread * 64; i < end; i++) {
+			uint8_t label = state[i].load(memory_order_relaxed);
+			if (label == IN) {
+				lab.set_in(i);
+			} else if (label == OUT) {
+				lab.set_out(i);
+			}
+			lab.num_attackers[i] = counter[i].load(memory_order_relaxed);
+		}
+	});
+}
+
+/*
+Derives the grounded labelling of 'reduct' from the grounded labelling of 'af'
+The reduct must be taken wrt a set that is conflict-free together with the grounded extension of af (e.g. an admissible set).
+Then all remaining arguments keep their label, and only undecided arguments that lost an attacker can become in,
+so the propagation starts from the arguments attacked by removed ones.
+
+@param af		the argumentation framework, with af.grounded computed
+@param reduct	a reduct of af
+@param origin	maps each argument of the reduct to its id in af
+@param removed	the arguments of af that are not in the reduct
+@param lab		the grounded labelling of the reduct
+*/
+void updateGroundedLabelling(const AF & af, const AF & reduct, const vector<uint32_t> & origin, const vector<uint32_t> & removed, Labelling & lab) {
+	const Labelling & parent = af.grounded;
+	reset_labelling(reduct.args, lab);
+
+	static thread_local vector<uint32_t> to_reduct;
+	to_reduct.assign(af.args, UINT32_MAX);
+	for (uint32_t i = 0; i < reduct.args; i++) {
+		uint32_t p = origin[i];
+		to_reduct[p] = i;
+		lab.num_attackers[i] = parent.num_attackers[p];
+		if (parent.is_in(p)) {
+			lab.set_in(i);
+		} else if (parent.is_out(p)) {
+			lab.set_out(i);
+		}
+	}
+
+	vector<uint32_t> arg_stack;
+	for (auto const& r: removed) {
+		// attackers that were out are not counted anyway
+		if (parent.is_out(r)) {
+			continue;
+		}
+		for (auto const& w: af.attacked[r]) {
+			uint32_t arg = to_reduct[w];
+			if (arg == UINT32_MAX || !lab.is_undec(arg) || lab.num_attackers[arg] == 0) {
+				continue;
+			}
+			lab.num_attackers[arg]--;
+			if (lab.num_attackers[arg] == 0) {
+				lab.set_in(arg);
+				arg_stack.push_back(arg);
+			}
+		}
+	}
+	propagate(reduct, lab, arg_stack);
+}
+
+// returns the arguments labelled in
+vector<uint32_t> getGroundedExtension(const AF & af, const Labelling & lab) {
+	vector<uint32_t> extension;
+	for (uint32_t i = 0; i < af.args; i++) {
+		if (lab.is_in(i)) {
+			extension.push_back(i);
+		}
+	}
+	return extension;
+}
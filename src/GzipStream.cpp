@@ -0,0 +1,74 @@
+#include "GzipStream.h"
+
+#include <cstdio>			// fileno, stdin
+#include <unistd.h>			// dup, close
+
+using namespace std;
+
+GzipStreamBuf::GzipStreamBuf() : file(NULL), error(false) {
+	setg(buffer, buffer, buffer);
+}
+
+GzipStreamBuf::~GzipStreamBuf() {
+	close();
+}
+
+bool GzipStreamBuf::open(const string & path) {
+	close();
+	error = false;
+	if (path == "-") {
+		// duplicate the descriptor, so that gzclose does not close <stdin> itself
+		int fd = dup(fileno(stdin));
+		if (fd < 0) {
+			return false;
+		}
+		file = gzdopen(fd, "rb");
+		if (file == NULL) {
+			::close(fd);
+		}
+	} else {
+		file = gzopen(path.c_str(), "rb");
+	}
+	if (file == NULL) {
+		return false;
+	}
+	gzbuffer(file, buffer_size);
+	setg(buffer, buffer, buffer);
+	return true;
+}
+
+bool GzipStreamBuf::is_open() const {
+	return file != NULL;
+}
+
+void GzipStreamBuf::close() {
+	if (file != NULL) {
+		gzclose(file);
+		file = NULL;
+	}
+}
+
+GzipStreamBuf::int_type GzipStreamBuf::underflow() {
+	if (gptr() < egptr()) {
+		return traits_type::to_int_type(*gptr());
+	}
+	if (file == NULL) {
+		return traits_type::eof();
+	}
+	int n = gzread(file, buffer, buffer_size);
+	if (n < 0) {
+		error = true;
+		return traits_type::eof();
+	}
+	if (n == 0) {
+		// zlib reports a compressed stream that ends prematurely as Z_BUF_ERROR
+		int errnum = Z_OK;
+		gzerror(file, &errnum);
+		if (errnum == Z_BUF_ERROR) {
+			error = true;
+		}
+		return traits_type::eof();
+	}
+	setg(buffer, buffer, buffer + n);
+	return traits_type::to_int_type(*gptr());
+}
@@ -0,0 +1,84 @@
+#include "Heuristics.h"
+
+using namespace std;
+
+heuristic string_to_heuristic(const string & name) {
+	for (int h = SOLVER_ORDER; h < UNKNOWN_HEURISTIC; h++) {
+		if (heuristic_to_string(static_cast<heuristic>(h)) == name) {
+			return static_cast<heuristic>(h);
+		}
+	}
+	return UNKNOWN_HEURISTIC;
+}
+
+string heuristic_to_string(heuristic h) {
+	switch (h) {
+		case SOLVER_ORDER: return "solver";
+		case QUERY_DIRECTED: return "query";
+		case QUERY_DISTANCE: return "distance";
+		case SHALLOW_FIRST: return "shallow";
+		default: return "unknown";
+	}
+}
+
+namespace Heuristics {
+
+heuristic branch_order = SOLVER_ORDER;
+
+BranchScorer::BranchScorer(const AF & af, uint32_t query, size_t depth) : af(af), depth(depth) {
+	if (branch_order == QUERY_DIRECTED) {
+		role.assign(af.args, 0);
+		for (auto const& attacker: af.attackers[query]) {
+			role[attacker] |= 1;
+		}
+		for (auto const& attacker: af.attackers[query]) {
+			for (auto const& defender: af.attackers[attacker]) {
+				role[defender] |= 2;
+			}
+		}
+	} else if (branch_order == QUERY_DISTANCE) {
+		// breadth-first search from the query against the direction of the attacks
+		distance.assign(af.args, UINT32_MAX);
+		vector<uint32_t> queue(1, query);
+		distance[query] = 0;
+		for (size_t i = 0; i < queue.size(); i++) {
+			uint32_t arg = queue[i];
+			for (auto const& attacker: af.attackers[arg]) {
+				if (distance[attacker] == UINT32_MAX) {
+					distance[attacker] = distance[arg] + 1;
+					queue.push_back(attacker);
+				}
+			}
+		}
+	}
+}
+
+/*
+The query-directed heuristics only rank branches of the same depth, deeper branches always come first:
+a counterexample is a complete extension, exploring breadth-first would queue an exponential number of branches before reaching one.
+*/
+int64_t BranchScorer::score(const vector<uint32_t> & initial_set) const {
+	const int64_t LIMIT = INT32_MAX;
+	int64_t score = 0;
+	switch (branch_order) {
+		case QUERY_DIRECTED:
+			for (auto const& arg: initial_set) {
+				for (auto const& target: af.attacked[arg]) {
+					score += role[target];
+				}
+			}
+			return int64_t(depth) * (LIMIT + 1) + min(score, LIMIT);
+		case QUERY_DISTANCE:
+			score = LIMIT;
+			for (auto const& arg: initial_set) {
+				score = min<int64_t>(score, distance[arg]);
+			}
+			return int64_t(depth) * (LIMIT + 1) + LIMIT - score;
+		case SHALLOW_FIRST:
+			return -int64_t(depth);
+		default:
+			return 0;
+	}
+}
+
+}
@@ -0,0 +1,97 @@
+#include "Kernel.h"
+#include "Util.h"
+
+using namespace std;
+
+namespace Kernel {
+
+string rule_to_string(rule r) {
+	switch (r) {
+		case DEAD_ATTACKS: return "dead-attacks";
+		case INERT_ARGUMENTS: return "inert-arguments";
+		default: return "unknown";
+	}
+}
+
+bool reduce(AF & af, vector<pair<string,string>> & atts, const string & keep, Report & report) {
+	Labelling grounded;
+	computeGroundedLabelling(af, grounded);
+	auto it = af.arg_to_int.find(keep);
+	uint32_t kept = it == af.arg_to_int.end() ? UINT32_MAX : it->second;
+
+	vector<uint8_t> dead(af.args, 0);
+	for (uint32_t i = 0; i < af.args; i++) {
+		dead[i] = i != kept && (af.self_attack[i] || grounded.is_out(i));
+	}
+
+	// self-attacks are kept, they are what makes an argument dead
+	auto dead_attack = [&dead](uint32_t source, uint32_t target) { return source != target && dead[source] && dead[target]; };
+
+	vector<uint8_t> removed(af.args, 0);
+	uint64_t dead_attacks = 0;
+	for (uint32_t i = 0; i < af.args; i++) {
+		if (!dead[i]) {
+			continue;
+		}
+		bool inert = true;
+		for (auto const& target: af.attacked[i]) {
+			if (dead_attack(i, target)) {
+				dead_attacks++;
+			} else if (target != i) {
+				inert = false;
+			}
+		}
+		if (inert) {
+			removed[i] = 1;
+			report.removed_args[INERT_ARGUMENTS]++;
+		}
+	}
+	// the framework is only rebuilt if a rule applies
+	if (dead_attacks == 0 && report.removed_args[INERT_ARGUMENTS] == 0) {
+		return false;
+	}
+
+	AF kernel = AF();
+	kernel.sem = af.sem;
+	for (uint32_t i = 0; i < af.args; i++) {
+		if (!removed[i]) {
+			kernel.add_argument(af.int_to_arg[i]);
+		}
+	}
+	kernel.initialize_attackers();
+
+	vector<pair<string,string>> kernel_atts;
+	kernel_atts.reserve(atts.size());
+	for (auto const& att: atts) {
+		auto source = af.arg_to_int.find(att.first);
+		auto target = af.arg_to_int.find(att.second);
+		if (source == af.arg_to_int.end() || target == af.arg_to_int.end()) {
+			continue;
+		}
+		if (dead_attack(source->second, target->second)) {
+			report.removed_attacks[DEAD_ATTACKS]++;
+			continue;
+		}
+		if (removed[source->second] || removed[target->second]) {
+			report.removed_attacks[INERT_ARGUMENTS]++;
+			continue;
+		}
+		kernel.add_attack(att);
+		kernel_atts.push_back(att);
+	}
+	atts = move(kernel_atts);
+
+	kernel.initialize_vars();
+	kernel.set_solver_path(af.solver_path);
+	af = move(kernel);
+	return true;
+}
+
+void print_report(const Report & report, ostream & out) {
+	for (int r = 0; r < NUM_RULES; r++) {
+		out << "kernel " << rule_to_string(static_cast<rule>(r)) << ": " << report.removed_args[r] << " arguments, "
+			<< report.removed_attacks[r] << " attacks removed\n";
+	}
+}
+
+}
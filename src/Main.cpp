@@ -33,10 +33,17 @@
 #include "AF.h"				// Modelling of argumentation frameworks
 #include "EnumExtensions.h"	// Naive methods for EE-IT,EE-UC
 #include "Problems.h"		// Methods for all supported Problems
+#include "GzipStream.h"		// reading (compressed) input from files and <stdin>
+#include "Scheduler.h"		// shared thread pool for all parallel computations
+#include "Heuristics.h"		// branch orders of the DS searches
+#include "Kernel.h"			// preprocessing of the input framework
 
 #include <iostream>			//std::cout
-#include <fstream>			//ifstream
+#include <cstdlib>			// std::atoi, std::strtoull
+#include <cctype>			// std::isdigit
+#include <cerrno>			// errno
 #include <algorithm>
+#include <chrono>
 #include <stack>
 
 #include <getopt.h>			// parsing commandline options
@@ -47,6 +54,10 @@ static int version_flag = 0;
 static int usage_flag = 0;
 static int formats_flag = 0;
 static int problems_flag = 0;
+static int compare_heuristics_flag = 0;
+static int incremental_flag = 0;
+static int no_kernel_flag = 0;
+static int kernel_stats_flag = 0;
 
 task string_to_task(string problem)
 {
@@ -70,14 +81,34 @@ semantics string_to_sem(string problem)
 	return UNKNOWN_SEM;
 }
 
+// parses a non-negative decimal number up to 'max', anything else (signs, trailing characters, overflow) is rejected
+bool parse_number(const char * str, uint64_t max, uint64_t & value)
+{
+	if (!isdigit(static_cast<unsigned char>(str[0]))) return false;
+	char * end;
+	errno = 0;
+	unsigned long long number = strtoull(str, &end, 10);
+	if (errno != 0 || *end != '\0' || number > max) return false;
+	value = number;
+	return true;
+}
+
 void print_usage(string solver_name)
 {
 	cout << "Usage: " << solver_name << " -p <task> -f <file> -fo <format> [-a <query>]\n\n";
 	cout << "  <task>      computational problem; for a list of available problems use option --problems\n";
-	cout << "  <file>      input argumentation framework\n";
+	cout << "  <file>      input argumentation framework (may be gzip-compressed); use '-' to read from <stdin>\n";
 	cout << "  <format>    file format for input AF; for a list of available formats use option --formats\n";
 	cout << "  <query>     query argument\n";
 	cout << "Options:\n";
+	cout << "  -j <n>      Number of worker threads (default: number of available CPUs).\n";
+	cout << "  --inline-size <n>  DS-PR reducts with fewer than <n> arguments are explored by the current task (default: 16),\n";
+	cout << "  --inline-cost <n>  provided their number of arguments plus attacks is below <n> (default: 64).\n";
+	cout << "  --heuristic <h>    Order of the branches for DS problems: solver (default), query, distance or shallow.\n";
+	cout << "  --compare-heuristics  Solves a DS problem with every heuristic and prints the running times to <stderr>.\n";
+	cout << "  --incremental  DS-PR: searches the initial sets of all reducts with one incremental SAT solver per thread.\n";
+	cout << "  --no-kernel    Solves the input framework without removing dead attacks and inert arguments first.\n";
+	cout << "  --kernel-stats Prints the number of arguments and attacks removed by each preprocessing rule to <stderr>.\n";
 	cout << "  --help      Displays this help message.\n";
 	cout << "  --version   Prints version and author information.\n";
 	cout << "  --formats   Prints available file formats.\n";
@@ -124,11 +155,19 @@ int main(int argc, char ** argv)
 		{"version", no_argument, &version_flag, 1},
 		{"formats", no_argument, &formats_flag, 1},
 		{"problems", no_argument, &problems_flag, 1},
+		{"compare-heuristics", no_argument, &compare_heuristics_flag, 1},
+		{"incremental", no_argument, &incremental_flag, 1},
+		{"no-kernel", no_argument, &no_kernel_flag, 1},
+		{"kernel-stats", no_argument, &kernel_stats_flag, 1},
 		{"p", required_argument, 0, 'p'},
 		{"f", required_argument, 0, 'f'},
 		{"fo", required_argument, 0, 'o'},
 		{"a", required_argument, 0, 'a'},
 		{"s", required_argument, 0, 's'},
+		{"j", required_argument, 0, 'j'},
+		{"inline-size", required_argument, 0, 'i'},
+		{"inline-cost", required_argument, 0, 'c'},
+		{"heuristic", required_argument, 0, 'h'},
 		{0, 0, 0, 0}
 	};
 
@@ -155,11 +194,43 @@ int main(int argc, char ** argv)
 			case 's':
 				sat_path = optarg;
 				break;
+			case 'j':
+				if (atoi(optarg) < 1) {
+					cerr << argv[0] << ": Number of threads must be positive\n";
+					return 1;
+				}
+				Scheduler::set_num_threads(atoi(optarg));
+				break;
+			case 'i':
+			{
+				uint64_t size;
+				if (!parse_number(optarg, UINT32_MAX, size)) {
+					cerr << argv[0] << ": Inline size must be a non-negative number\n";
+					return 1;
+				}
+				Granularity::min_task_size = size;
+				break;
+			}
+			case 'c':
+				if (!parse_number(optarg, UINT64_MAX, Granularity::min_task_cost)) {
+					cerr << argv[0] << ": Inline cost must be a non-negative number\n";
+					return 1;
+				}
+				break;
+			case 'h':
+				Heuristics::branch_order = string_to_heuristic(optarg);
+				if (Heuristics::branch_order == UNKNOWN_HEURISTIC) {
+					cerr << argv[0] << ": Unknown heuristic " << optarg << "\n";
+					return 1;
+				}
+				break;
 			default:
 				return 1;
 		}
 	}
 
+	Problems::incremental_sat = incremental_flag;
+
 	if (version_flag) {
 		print_version(argv[0]);
 		return 0;
@@ -195,10 +266,10 @@ int main(int argc, char ** argv)
 		return 1;
 	}
 
-	ifstream input;
-	input.open(file);
+	GzipStreamBuf input_buffer;
+	istream input(&input_buffer);
 
-	if (!input.good()) {
+	if (!input_buffer.open(file)) {
 		cerr << argv[0] << ": Cannot open input file\n";
 		return 1;
 	}
@@ -246,7 +317,11 @@ int main(int argc, char ** argv)
 		return 1;
 	}
 
-	input.close();
+	if (input_buffer.failed()) {
+		cerr << argv[0] << ": Cannot read input file\n";
+		return 1;
+	}
+	input_buffer.close();
 
 	af.sem = string_to_sem(task);
 
@@ -296,6 +371,15 @@ int main(int argc, char ** argv)
 
 	af.set_solver_path(sat_path);
 
+	// the grounded extension is computed directly, all other problems are solved on the kernel of the framework
+	if (!no_kernel_flag && string_to_sem(task) != GR) {
+		Kernel::Report report;
+		Kernel::reduce(af, atts, query, report);
+		if (kernel_stats_flag) {
+			Kernel::print_report(report, cerr);
+		}
+	}
+
 	switch (string_to_task(task)) {
 		case DS:
 		{
@@ -303,18 +387,27 @@ int main(int argc, char ** argv)
 				cerr << argv[0] << ": Query argument must be specified via -a flag\n";
 				return 1;
 			}
+			if (string_to_sem(task) != PR && string_to_sem(task) != UC) {
+				cerr << argv[0] << ": Unsupported semantics\n";
+				return 1;
+			}
+			// with --compare-heuristics the query is solved once per heuristic
+			int first = compare_heuristics_flag ? SOLVER_ORDER : Heuristics::branch_order;
+			int last = compare_heuristics_flag ? UNKNOWN_HEURISTIC - 1 : Heuristics::branch_order;
 			bool skept_accepted = false;
-			switch (string_to_sem(task)) {
-				case PR:
+			for (int h = first; h <= last; h++) {
+				Heuristics::branch_order = static_cast<heuristic>(h);
+				auto start = chrono::steady_clock::now();
+				if (string_to_sem(task) == PR) {
 					//skept_accepted = Problems::mt_ds_preferred(af, query);
 					skept_accepted = Problems::ds_preferred(af, query, atts);
-					break;
-				case UC:
+				} else {
 					skept_accepted = Problems::ds_unchallenged(af, query, atts);
-					break;
-				default:
-					cerr << argv[0] << ": Unsupported semantics\n";
-					return 1;
+				}
+				if (compare_heuristics_flag) {
+					auto ms = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start).count();
+					cerr << heuristic_to_string(Heuristics::branch_order) << ": " << (skept_accepted ? "YES" : "NO") << " in " << ms << " ms\n";
+				}
 			}
 			cout << (skept_accepted ? "YES" : "NO") << "\n";
 			break;
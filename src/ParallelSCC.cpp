@@ -0,0 +1,269 @@
+#include "Util.h"
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+using namespace std;
+
+/*
+Parallel computation of the SCCs for very large frameworks, combining trimming with the forward-backward algorithm.
+
+Every argument that is not yet assigned to an SCC belongs to a part, and every SCC lies inside a single part.
+Trimming removes arguments without attackers or without attacked arguments inside their part, these are singleton SCCs.
+Forward-backward picks a pivot of a part, its SCC is the intersection of the arguments reachable from and reaching the pivot,
+and the remaining arguments split into three new parts that are processed independently.
+
+Each part owns a contiguous range of positions, ordered such that the SCCs end up in reverse topological order,
+i.e., in the same order as with Tarjan's algorithm:
+[trimmed sinks][forward only][neither][pivot SCC][backward only][trimmed sources]
+*/
+
+namespace {
+
+const uint32_t SETTLED = UINT32_MAX;
+
+// parts smaller than this are processed by the current task instead of posting a new one
+const size_t PARALLEL_SCC_GRAIN = 4096;
+
+struct ParallelSCCState {
+	const AF & af;
+	unique_ptr<atomic<uint32_t>[]> part;
+	unique_ptr<atomic<uint32_t>[]> in_degree;
+	unique_ptr<atomic<uint32_t>[]> out_degree;
+	vector<uint8_t> fw_mark;
+	vector<uint8_t> bw_mark;
+	vector<uint32_t> order;
+	vector<uint8_t> scc_start;
+	atomic<uint32_t> next_part;
+	TaskGroup tasks;
+
+	ParallelSCCState(const AF & af) : af(af), part(new atomic<uint32_t>[af.args]), in_degree(new atomic<uint32_t>[af.args]),
+		out_degree(new atomic<uint32_t>[af.args]), fw_mark(af.args, 0), bw_mark(af.args, 0), order(af.args), scc_start(af.args, 0),
+		next_part(1) {}
+
+	bool in_part(uint32_t arg, uint32_t p) const { return part[arg].load(memory_order_relaxed) == p; }
+
+	void place(uint32_t arg, uint32_t pos) {
+		order[pos] = arg;
+		scc_start[pos] = 1;
+	}
+};
+
+/*
+Removes trimmable arguments starting from 'queue', positions are claimed from the shared counters 'lo' (sinks) and 'hi' (sources)
+An argument is claimed by the thread that settles it, so arguments may be pushed more than once.
+*/
+template <class Counter>
+void trim(ParallelSCCState & st, uint32_t p, vector<uint32_t> & queue, Counter & lo, Counter & hi) {
+	const AF & af = st.af;
+	for (size_t q = 0; q < queue.size(); q++) {
+		uint32_t v = queue[q];
+		uint32_t expected = p;
+		if (!st.part[v].compare_exchange_strong(expected, SETTLED)) {
+			continue;
+		}
+		if (st.out_degree[v].load() == 0) {
+			st.place(v, lo++);
+		} else {
+			st.place(v, --hi);
+		}
+		for (auto const& w: af.attacked[v]) {
+			if (w != v && st.in_part(w, p) && st.in_degree[w].fetch_sub(1) == 1) {
+				queue.push_back(w);
+			}
+		}
+		for (auto const& u: af.attackers[v]) {
+			if (u != v && st.in_part(u, p) && st.out_degree[u].fetch_sub(1) == 1) {
+				queue.push_back(u);
+			}
+		}
+	}
+}
+
+void reach(ParallelSCCState & st, uint32_t p, uint32_t pivot, bool forward, vector<uint32_t> & stack) {
+	vector<uint8_t> & mark = forward ? st.fw_mark : st.bw_mark;
+	stack.clear();
+	stack.push_back(pivot);
+	mark[pivot] = 1;
+	while (!stack.empty()) {
+		uint32_t v = stack.back();
+		stack.pop_back();
+		for (auto const& w: forward ? st.af.attacked[v] : st.af.attackers[v]) {
+			// marks of arguments in other parts are written concurrently by the tasks owning these parts
+			if (st.in_part(w, p) && !mark[w]) {
+				mark[w] = 1;
+				stack.push_back(w);
+			}
+		}
+	}
+}
+
+void forward_backward(ParallelSCCState & st, uint32_t p, vector<uint32_t> args, uint32_t lo, bool trimmed);
+
+// hands a part over to the scheduler or keeps it in the local worklist
+void spawn_part(ParallelSCCState & st, vector<uint32_t> & args, uint32_t lo, vector<pair<vector<uint32_t>,uint32_t>> & worklist) {
+	if (args.empty()) {
+		return;
+	}
+	uint32_t p = st.next_part++;
+	for (auto const& a: args) {
+		st.part[a].store(p, memory_order_relaxed);
+	}
+	if (args.size() < PARALLEL_SCC_GRAIN) {
+		worklist.push_back(make_pair(move(args), lo));
+	} else {
+		ParallelSCCState * state = &st;
+		shared_ptr<vector<uint32_t>> part_args = make_shared<vector<uint32_t>>(move(args));
+		st.tasks.run([state, p, part_args, lo] { forward_backward(*state, p, move(*part_args), lo, false); });
+	}
+}
+
+void forward_backward(ParallelSCCState & st, uint32_t p, vector<uint32_t> args, uint32_t lo, bool trimmed) {
+	const AF & af = st.af;
+	vector<pair<vector<uint32_t>,uint32_t>> worklist;
+	vector<uint32_t> queue, stack, fw, bw, rest;
+
+	while (true) {
+		uint32_t hi = lo + args.size();
+		if (!trimmed) {
+			// degrees inside the part
+			queue.clear();
+			for (auto const& v: args) {
+				uint32_t in = 0, out = 0;
+				for (auto const& u: af.attackers[v]) {
+					if (u != v && st.in_part(u, p)) in++;
+				}
+				for (auto const& w: af.attacked[v]) {
+					if (w != v && st.in_part(w, p)) out++;
+				}
+				st.in_degree[v].store(in, memory_order_relaxed);
+				st.out_degree[v].store(out, memory_order_relaxed);
+				if (in == 0 || out == 0) {
+					queue.push_back(v);
+				}
+			}
+			trim(st, p, queue, lo, hi);
+			args.erase(remove_if(args.begin(), args.end(), [&st, p](uint32_t a) { return !st.in_part(a, p); }), args.end());
+		}
+
+		if (!args.empty()) {
+			uint32_t pivot = args[0];
+			reach(st, p, pivot, true, stack);
+			reach(st, p, pivot, false, stack);
+
+			fw.clear(); bw.clear(); rest.clear();
+			uint32_t scc_size = 0;
+			for (auto const& v: args) {
+				if (st.fw_mark[v] && st.bw_mark[v]) {
+					scc_size++;
+				} else if (st.fw_mark[v]) {
+					fw.push_back(v);
+				} else if (st.bw_mark[v]) {
+					bw.push_back(v);
+				} else {
+					rest.push_back(v);
+				}
+			}
+			uint32_t rest_lo = lo + fw.size();
+			uint32_t scc_lo = rest_lo + rest.size();
+			uint32_t bw_lo = scc_lo + scc_size;
+			uint32_t pos = scc_lo;
+			st.scc_start[pos] = 1;
+			for (auto const& v: args) {
+				if (st.fw_mark[v] && st.bw_mark[v]) {
+					st.order[pos++] = v;
+					st.part[v].store(SETTLED, memory_order_relaxed);
+				}
+				st.fw_mark[v] = 0;
+				st.bw_mark[v] = 0;
+			}
+
+			spawn_part(st, fw, lo, worklist);
+			spawn_part(st, rest, rest_lo, worklist);
+			spawn_part(st, bw, bw_lo, worklist);
+		}
+
+		if (worklist.empty()) {
+			return;
+		}
+		args = move(worklist.back().first);
+		lo = worklist.back().second;
+		worklist.pop_back();
+		p = st.part[args[0]].load(memory_order_relaxed);
+		trimmed = false;
+	}
+}
+
+}
+
+/*
+Computes the SCCs of 'af' with the given number of threads
+The partition and the reverse topological order of the result are the same as for Tarjan's algorithm,
+only the order of incomparable SCCs and of the members of an SCC may differ.
+*/
+void computeStronglyConnectedComponentsParallel(const AF & af, SCCs & sccs, uint32_t num_threads) {
+	num_threads = max(num_threads, 1u);
+	ParallelSCCState st(af);
+
+	// initial degrees, every argument starts in part 0
+	uint32_t chunk = (af.args + num_threads - 1) / num_threads;
+	vector<vector<uint32_t>> queues(num_threads);
+	for (uint32_t t = 0; t < num_threads; t++) {
+		st.tasks.run([&st, &af, &queues, t, chunk] {
+			uint32_t end = min(af.args, (t + 1) * chunk);
+			for (uint32_t v = t * chunk; v < end; v++) {
+				uint32_t in = 0, out = 0;
+				for (auto const& u: af.attackers[v]) if (u != v) in++;
+				for (auto const& w: af.attacked[v]) if (w != v) out++;
+				st.part[v].store(0, memory_order_relaxed);
+				st.in_degree[v].store(in, memory_order_relaxed);
+				st.out_degree[v].store(out, memory_order_relaxed);
+				if (in == 0 || out == 0) {
+					queues[t].push_back(v);
+				}
+			}
+		});
+	}
+	st.tasks.wait();
+
+	// parallel trimming of the whole framework, this settles all acyclic parts
+	atomic<uint32_t> lo(0), hi(af.args);
+	for (uint32_t t = 0; t < num_threads; t++) {
+		st.tasks.run([&st, &queues, &lo, &hi, t] {
+			trim(st, 0, queues[t], lo, hi);
+		});
+	}
+	st.tasks.wait();
+	queues.clear();
+
+	// forward-backward on the remaining arguments, all of them lie on cycles
+	vector<uint32_t> remaining;
+	remaining.reserve(hi - lo);
+	for (uint32_t v = 0; v < af.args; v++) {
+		if (st.in_part(v, 0)) {
+			remaining.push_back(v);
+		}
+	}
+	if (!remaining.empty()) {
+		uint32_t start = lo;
+		st.tasks.run([&st, &remaining, start] { forward_backward(st, 0, move(remaining), start, true); });
+		st.tasks.wait();
+	}
+
+	// collect the SCCs from the positions
+	sccs.component.resize(af.args);
+	sccs.members = move(st.order);
+	sccs.offsets.assign(1, 0);
+	for (uint32_t pos = 0; pos < af.args; pos++) {
+		if (pos > 0 && st.scc_start[pos]) {
+			sccs.offsets.push_back(pos);
+		}
+		sccs.component[sccs.members[pos]] = sccs.offsets.size() - 1;
+	}
+	if (af.args > 0) {
+		sccs.offsets.push_back(af.args);
+	}
+}
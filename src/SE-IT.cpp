@@ -1,15 +1,32 @@
 #include "Problems.h"
+#include "Scheduler.h"
+#include "SmallSCC.h"
+#include "Structure.h"
+
+#include <algorithm>
+#include <atomic>
 
 using namespace std;
 
 namespace Problems {
 
-bool se_initial(const AF & af) {
+/*
+Searches one minimal admissible set within 'scc', i.e., an initial set of the SCC
+@returns 'false' if the SCC has no initial set or the search was cancelled
+*/
+static bool find_scc_initial_set(const AF & af, const vector<uint32_t> & scc, vector<uint32_t> & extension) {
+	vector<vector<uint32_t>> initial_sets;
+	if (Structure::initial_sets(af, scc, initial_sets) || SmallSCC::initial_sets(af, scc, initial_sets)) {
+		if (initial_sets.empty()) {
+			return false;
+		}
+		extension = initial_sets[0];
+		return true;
+	}
 	SAT_Solver solver = SAT_Solver(af.count, af.solver_path);
-	Encodings::add_nonempty(af, solver);
 	Encodings::add_admissible(af, solver);
+	Encodings::add_nonempty_subset_of(af, scc, solver);
 
-	vector<uint32_t> extension;
 	bool foundExt = false;
 	while (true) {
 		int sat = solver.solve();
@@ -21,7 +38,7 @@ bool se_initial(const AF & af) {
 				extension.push_back(i);
 			}
 		}
-		
+
 		vector<int> min_complement_clause;
 		min_complement_clause.reserve(af.args);
 		for (uint32_t i = 0; i < af.args; i++) {
@@ -36,8 +53,50 @@ bool se_initial(const AF & af) {
 		}
 		solver.addMinimizationClause(min_complement_clause);
 	}
-	if (foundExt) {
-		print_extension_ee(af, extension);
+	// an interrupted minimisation may have stopped at a set that is not minimal
+	TaskGroup * group = TaskGroup::current();
+	return foundExt && (group == NULL || !group->is_cancelled());
+}
+
+/*
+An unattacked argument is an initial set on its own and is returned right away.
+Otherwise the SCCs are searched separately, smallest first and in parallel: the first initial set found is returned and the other
+searches are cancelled. Without unattacked arguments the grounded extension is empty, so no argument can be excluded upfront.
+*/
+bool se_initial(const AF & af) {
+	for (uint32_t i = 0; i < af.args; i++) {
+		if (af.unattacked[i]) {
+			print_extension_ee(af, vector<uint32_t>(1, i));
+			return true;
+		}
+	}
+
+	SCCs sccs;
+	computeStronglyConnectedComponents(af, sccs);
+	vector<uint32_t> order(sccs.num_sccs());
+	for (uint32_t i = 0; i < order.size(); i++) {
+		order[i] = i;
+	}
+	stable_sort(order.begin(), order.end(), [&sccs](uint32_t a, uint32_t b) { return sccs.scc_size(a) < sccs.scc_size(b); });
+
+	atomic<bool> found(false);
+	vector<uint32_t> result;
+	TaskGroup * outer = TaskGroup::current();
+	for_each_scc_enumeration(af, order.size(), [&](uint32_t k) {
+		vector<uint32_t> extension;
+		if (found.load() || !find_scc_initial_set(af, sccs.get_scc(order[k]), extension) || found.exchange(true)) {
+			return;
+		}
+		result = move(extension);
+		// stop the searches of the other SCCs, unless they run one after the other in the caller's task
+		TaskGroup * group = TaskGroup::current();
+		if (group != outer) {
+			group->cancel();
+		}
+	});
+
+	if (found.load()) {
+		print_extension_ee(af, result);
 		return true;
 	} else {
 		std::cout << "NO\n";
@@ -45,4 +104,4 @@ bool se_initial(const AF & af) {
 	}
 }
 
-}
\ No newline at end of file
+}
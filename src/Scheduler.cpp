@@ -0,0 +1,258 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sched.h>				// sched_getaffinity
+
+using namespace std;
+
+uint32_t Scheduler::requested_threads = 0;
+
+uint32_t Granularity::min_task_size = 16;
+uint64_t Granularity::min_task_cost = 64;
+
+// index of the worker running on this thread, -1 for threads outside the pool
+static thread_local int32_t current_worker = -1;
+
+// group of the task running on this thread
+static thread_local TaskGroup * current_group = NULL;
+
+Scheduler & Scheduler::instance() {
+	static Scheduler scheduler(requested_threads > 0 ? requested_threads : available_cpus());
+	return scheduler;
+}
+
+// has to be called before the scheduler is used for the first time
+void Scheduler::set_num_threads(uint32_t num_threads) {
+	requested_threads = num_threads;
+}
+
+/*
+Number of CPUs this process may use: the CPUs in its affinity mask, limited by the CPU quota of its cgroup (v2 or v1)
+*/
+uint32_t Scheduler::available_cpus() {
+	uint32_t cpus = std::thread::hardware_concurrency();
+	cpu_set_t set;
+	if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+		cpus = CPU_COUNT(&set);
+	}
+
+	long quota = -1, period = 0;
+	ifstream cpu_max("/sys/fs/cgroup/cpu.max");
+	string max_str;
+	if (cpu_max >> max_str >> period) {
+		if (max_str != "max") {
+			quota = stol(max_str);
+		}
+	} else {
+		ifstream quota_file("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+		ifstream period_file("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+		if (!(quota_file >> quota) || !(period_file >> period)) {
+			quota = -1;
+		}
+	}
+	if (quota > 0 && period > 0) {
+		cpus = min<long>(cpus, (quota + period - 1) / period);
+	}
+	return max(cpus, 1u);
+}
+
+Scheduler::Scheduler(uint32_t num_threads) : queued(0), sleepers(0), stop(false) {
+	for (uint32_t t = 0; t < num_threads; t++) {
+		workers.push_back(unique_ptr<Worker>(new Worker()));
+	}
+	for (uint32_t t = 0; t < num_threads; t++) {
+		workers[t]->thread = std::thread([this, t] { work(t); });
+	}
+}
+
+Scheduler::~Scheduler() {
+	{
+		lock_guard<mutex> lock(sleep_mtx);
+		stop = true;
+	}
+	sleep_cv.notify_all();
+	for (auto & w: workers) {
+		w->thread.join();
+	}
+}
+
+void Scheduler::post(TaskGroup & group, function<void()> fn) {
+	if (group.is_cancelled()) {
+		return;
+	}
+	group.pending++;
+	Worker & queue = current_worker >= 0 ? *workers[current_worker] : injection;
+	{
+		lock_guard<mutex> lock(queue.mtx);
+		queue.tasks.push_back(Task{move(fn), &group});
+	}
+	queued++;
+	if (sleepers.load() > 0) {
+		lock_guard<mutex> lock(sleep_mtx);
+		sleep_cv.notify_one();
+	}
+}
+
+// takes the newest task of the own deque, otherwise the oldest task posted from outside or of another worker
+bool Scheduler::pop(int32_t id, Task & task) {
+	if (queued.load() == 0) {
+		return false;
+	}
+	if (id >= 0) {
+		Worker & own = *workers[id];
+		lock_guard<mutex> lock(own.mtx);
+		if (!own.tasks.empty()) {
+			task = move(own.tasks.back());
+			own.tasks.pop_back();
+			queued--;
+			return true;
+		}
+	}
+	uint32_t n = workers.size();
+	for (uint32_t i = 0; i <= n; i++) {
+		Worker & victim = i == 0 ? injection : *workers[(id + i) % n];
+		lock_guard<mutex> lock(victim.mtx);
+		if (!victim.tasks.empty()) {
+			task = move(victim.tasks.front());
+			victim.tasks.pop_front();
+			queued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void Scheduler::execute(Task & task) {
+	TaskGroup * outer = current_group;
+	current_group = task.group;
+	if (!task.group->is_cancelled()) {
+		task.fn();
+	}
+	current_group = outer;
+	task.group->finish_task();
+}
+
+// removes all queued tasks of the group from the deques, returns their number
+uint64_t Scheduler::drop(TaskGroup & group) {
+	uint64_t dropped = 0;
+	for (uint32_t i = 0; i <= workers.size(); i++) {
+		Worker & w = i == 0 ? injection : *workers[i - 1];
+		lock_guard<mutex> lock(w.mtx);
+		auto end = remove_if(w.tasks.begin(), w.tasks.end(), [&group](const Task & t) { return t.group == &group; });
+		uint64_t n = w.tasks.end() - end;
+		if (n > 0) {
+			w.tasks.erase(end, w.tasks.end());
+			queued -= n;
+			dropped += n;
+		}
+	}
+	return dropped;
+}
+
+bool Scheduler::try_run_one(int32_t id) {
+	Task task;
+	if (!pop(id, task)) {
+		return false;
+	}
+	execute(task);
+	return true;
+}
+
+void Scheduler::work(uint32_t id) {
+	current_worker = id;
+	while (true) {
+		if (try_run_one(id)) {
+			continue;
+		}
+		unique_lock<mutex> lock(sleep_mtx);
+		sleepers++;
+		sleep_cv.wait(lock, [this] { return stop || queued.load() > 0; });
+		sleepers--;
+		if (stop) {
+			return;
+		}
+	}
+}
+
+void TaskGroup::finish_task() {
+	lock_guard<mutex> lock(mtx);
+	if (--pending == 0) {
+		done_cv.notify_all();
+	}
+}
+
+/*
+Blocks until all tasks of the group have finished, afterwards the group can be used for the next query
+A worker that waits keeps executing tasks in the meantime, so groups can be nested inside tasks.
+If there is nothing to run (the remaining tasks of the group were stolen), the worker sleeps until the last task finishes;
+tasks posted in the meantime are picked up after at most one timeout, sleeping workers are woken for them anyway.
+*/
+void TaskGroup::wait() {
+	if (current_worker >= 0) {
+		Scheduler & scheduler = Scheduler::instance();
+		while (pending.load() > 0) {
+			if (scheduler.try_run_one(current_worker)) {
+				continue;
+			}
+			unique_lock<mutex> lock(mtx);
+			done_cv.wait_for(lock, chrono::milliseconds(1), [this, &scheduler] { return pending.load() == 0 || scheduler.queued.load() > 0; });
+		}
+	}
+	unique_lock<mutex> lock(mtx);
+	done_cv.wait(lock, [this] { return pending.load() == 0; });
+	cancelled = false;
+}
+
+/*
+Stops the group: queued tasks are removed at once, tasks posted later are ignored,
+and the running tasks are signalled through the interrupt flags of their SAT calls.
+Running tasks have to check is_cancelled() (or their own termination flag) and return.
+*/
+void TaskGroup::cancel() {
+	cancelled = true;
+	{
+		lock_guard<mutex> lock(mtx);
+		for (auto const& flag: interrupts) {
+			flag->store(true);
+		}
+	}
+	uint64_t dropped = Scheduler::instance().drop(*this);
+	if (dropped > 0) {
+		lock_guard<mutex> lock(mtx);
+		pending -= dropped;
+		if (pending == 0) {
+			done_cv.notify_all();
+		}
+	}
+}
+
+TaskGroup * TaskGroup::current() {
+	return current_group;
+}
+
+// registers the interrupt flag of a SAT call, it is set right away if the group is already cancelled
+void TaskGroup::add_interrupt(atomic<bool> * flag) {
+	if (parent != NULL) {
+		parent->add_interrupt(flag);
+	}
+	lock_guard<mutex> lock(mtx);
+	interrupts.push_back(flag);
+	if (cancelled) {
+		flag->store(true);
+	}
+}
+
+void TaskGroup::remove_interrupt(atomic<bool> * flag) {
+	if (parent != NULL) {
+		parent->remove_interrupt(flag);
+	}
+	lock_guard<mutex> lock(mtx);
+	interrupts.erase(find(interrupts.begin(), interrupts.end(), flag));
+}
+
+TaskGroup::~TaskGroup() {
+	// a finishing task may still hold the lock
+	lock_guard<mutex> lock(mtx);
+}
@@ -0,0 +1,173 @@
+#include "SmallSCC.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+
+// set to 0 to search all SCCs with the SAT solver, e.g. to check the results of this search against it
+#ifndef SCC_FAST_PATHS
+#define SCC_FAST_PATHS 1
+#endif
+
+using namespace std;
+
+namespace SmallSCC {
+
+uint64_t node_limit = 1 << 16;
+
+namespace {
+
+inline uint64_t bit(uint32_t i) { return uint64_t(1) << i; }
+
+inline uint32_t lowest(uint64_t mask) { return __builtin_ctzll(mask); }
+
+/*
+Backtracking search over the subsets of an SCC, as masks over the positions of its arguments
+A set that is not yet admissible picks the attacker with the fewest possible defenders and branches on adding one of them.
+Every minimal admissible set M is reached from any of its members: the attackers of a subset of M are defended by further members of M.
+*/
+class Search {
+public:
+	Search(const AF & af, const vector<uint32_t> & scc);
+	bool run();
+	vector<uint64_t> minimal() const;
+
+private:
+	uint32_t n;
+	vector<uint64_t> attacks;		// arguments of the SCC attacked by each argument
+	vector<uint64_t> attackers;		// arguments of the SCC attacking each argument
+	uint64_t excluded;				// self-attacking arguments and arguments attacked from outside the SCC, they cannot be defended
+	vector<uint64_t> admissible;	// admissible sets found so far, not necessarily minimal
+	unordered_set<uint64_t> visited;
+	uint64_t nodes;
+
+	bool extend(uint64_t set, uint64_t attacked);
+};
+
+Search::Search(const AF & af, const vector<uint32_t> & scc) : n(scc.size()), attacks(n, 0), attackers(n, 0), excluded(0), nodes(0) {
+	// position of each argument within the SCC, found by binary search to stay independent of the size of the framework
+	vector<pair<uint32_t,uint32_t>> position;
+	for (uint32_t i = 0; i < n; i++) {
+		position.push_back(make_pair(scc[i], i));
+	}
+	sort(position.begin(), position.end());
+	auto find = [&position](uint32_t arg, uint32_t & pos) {
+		auto it = lower_bound(position.begin(), position.end(), make_pair(arg, uint32_t(0)));
+		if (it == position.end() || it->first != arg) {
+			return false;
+		}
+		pos = it->second;
+		return true;
+	};
+
+	vector<uint8_t> attacked_from_outside = getAttackedFromOutside(af, scc);
+	for (uint32_t i = 0; i < n; i++) {
+		uint32_t arg = scc[i];
+		if (af.self_attack[arg] || attacked_from_outside[i]) {
+			excluded |= bit(i);
+		}
+		for (auto const& attacker: af.attackers[arg]) {
+			uint32_t pos;
+			if (find(attacker, pos)) {
+				attackers[i] |= bit(pos);
+				attacks[pos] |= bit(i);
+			}
+		}
+	}
+}
+
+// returns 'false' once the node limit is exceeded
+bool Search::extend(uint64_t set, uint64_t attacked) {
+	if (++nodes > node_limit) {
+		return false;
+	}
+	if (!visited.insert(set).second) {
+		return true;
+	}
+	// a proper superset of an admissible set is not minimal
+	for (auto const& found: admissible) {
+		if ((found & ~set) == 0) {
+			return true;
+		}
+	}
+
+	uint64_t undefended = 0;
+	for (uint64_t rest = set; rest; rest &= rest - 1) {
+		undefended |= attackers[lowest(rest)];
+	}
+	undefended &= ~attacked;
+	if (!undefended) {
+		admissible.push_back(set);
+		return true;
+	}
+
+	// defenders that can be added without conflict: not excluded, not attacked by the set, not attacking it
+	uint64_t allowed = ~(excluded | set | attacked);
+	uint64_t best = 0;
+	uint32_t best_count = n + 1;
+	for (uint64_t rest = undefended; rest; rest &= rest - 1) {
+		uint64_t candidates = attackers[lowest(rest)] & allowed;
+		uint32_t count = __builtin_popcountll(candidates);
+		if (count < best_count) {
+			best = candidates;
+			best_count = count;
+		}
+	}
+	for (uint64_t rest = best; rest; rest &= rest - 1) {
+		uint32_t defender = lowest(rest);
+		if ((attacks[defender] & set) == 0 && !extend(set | bit(defender), attacked | attacks[defender])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Search::run() {
+	for (uint32_t i = 0; i < n; i++) {
+		if (!(excluded & bit(i)) && !extend(bit(i), attacks[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+vector<uint64_t> Search::minimal() const {
+	vector<uint64_t> result;
+	for (auto const& set: admissible) {
+		bool is_minimal = true;
+		for (auto const& other: admissible) {
+			if (other != set && (other & ~set) == 0) {
+				is_minimal = false;
+				break;
+			}
+		}
+		if (is_minimal) {
+			result.push_back(set);
+		}
+	}
+	return result;
+}
+
+}
+
+bool initial_sets(const AF & af, const vector<uint32_t> & scc, vector<vector<uint32_t>> & initial_sets) {
+	if (!SCC_FAST_PATHS || scc.empty() || scc.size() > MAX_ARGS) {
+		return false;
+	}
+	Search search(af, scc);
+	if (!search.run()) {
+		return false;
+	}
+	for (auto const& set: search.minimal()) {
+		vector<uint32_t> initial_set;
+		for (uint64_t rest = set; rest; rest &= rest - 1) {
+			initial_set.push_back(scc[lowest(rest)]);
+		}
+		sort(initial_set.begin(), initial_set.end());
+		initial_sets.push_back(move(initial_set));
+	}
+	return true;
+}
+
+}
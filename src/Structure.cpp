@@ -0,0 +1,113 @@
+#include "Structure.h"
+#include "Util.h"
+
+#include <algorithm>
+
+// set to 0 to disable the closed forms, e.g. to check them against the SAT search
+#ifndef SCC_FAST_PATHS
+#define SCC_FAST_PATHS 1
+#endif
+
+using namespace std;
+
+namespace Structure {
+
+scc_shape classify(const AF & af, const vector<uint32_t> & scc) {
+	if (scc.size() < 2) {
+		return GENERAL_SCC;
+	}
+	vector<uint32_t> members(scc);
+	sort(members.begin(), members.end());
+	auto member = [&members](uint32_t arg) { return binary_search(members.begin(), members.end(), arg); };
+
+	// a strongly connected component in which every member has one attacker and one target within the component is a simple cycle
+	bool cycle = true;
+	bool symmetric = true;
+	for (auto const& arg: scc) {
+		uint32_t inner_attackers = 0;
+		for (auto const& attacker: af.attackers[arg]) {
+			if (!member(attacker)) {
+				continue;
+			}
+			inner_attackers++;
+			if (attacker != arg && !af.symmetric_attack.at(make_pair(attacker, arg))) {
+				symmetric = false;
+			}
+		}
+		uint32_t inner_targets = 0;
+		for (auto const& target: af.attacked[arg]) {
+			inner_targets += member(target);
+		}
+		if (inner_attackers != 1 || inner_targets != 1) {
+			cycle = false;
+		}
+		if (!cycle && !symmetric) {
+			return GENERAL_SCC;
+		}
+	}
+	// a cycle of two arguments is symmetric as well, both answers agree
+	if (cycle) {
+		return scc.size() % 2 ? ODD_CYCLE : EVEN_CYCLE;
+	}
+	return SYMMETRIC_SCC;
+}
+
+bool initial_sets(const AF & af, const vector<uint32_t> & scc, vector<vector<uint32_t>> & initial_sets) {
+	scc_shape shape = SCC_FAST_PATHS ? classify(af, scc) : GENERAL_SCC;
+	if (shape == GENERAL_SCC) {
+		return false;
+	}
+	vector<uint32_t> members(scc);
+	sort(members.begin(), members.end());
+	// arguments attacked from outside the SCC cannot be defended
+	vector<uint8_t> outside = getAttackedFromOutside(af, members);
+	auto attacked_from_outside = [&](uint32_t arg) {
+		return outside[lower_bound(members.begin(), members.end(), arg) - members.begin()] != 0;
+	};
+
+	if (shape == SYMMETRIC_SCC) {
+		for (auto const& arg: members) {
+			if (!af.self_attack[arg] && !attacked_from_outside(arg)) {
+				initial_sets.push_back(vector<uint32_t>(1, arg));
+			}
+		}
+	} else if (shape == EVEN_CYCLE) {
+		// every member of an admissible subset of the cycle needs the member two steps back, so only the alternating halves remain
+		vector<uint32_t> halves[2];
+		bool defended[2] = {true, true};
+		uint32_t arg = scc[0];
+		for (uint32_t i = 0; i < scc.size(); i++) {
+			halves[i % 2].push_back(arg);
+			if (attacked_from_outside(arg)) {
+				defended[i % 2] = false;
+			}
+			for (auto const& target: af.attacked[arg]) {
+				if (binary_search(members.begin(), members.end(), target)) {
+					arg = target;
+					break;
+				}
+			}
+		}
+		for (int h = 0; h < 2; h++) {
+			if (defended[h]) {
+				sort(halves[h].begin(), halves[h].end());
+				initial_sets.push_back(halves[h]);
+			}
+		}
+	}
+	return true;
+}
+
+bool is_acyclic(const AF & af, const SCCs & sccs) {
+	if (!SCC_FAST_PATHS || sccs.num_sccs() != af.args) {
+		return false;
+	}
+	for (uint32_t i = 0; i < af.args; i++) {
+		if (af.self_attack[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+}
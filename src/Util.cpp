@@ -1,12 +1,19 @@
 #include "Encodings.h"
 #include "Util.h"
+#include "Scheduler.h"
 
 #include <unordered_set>
-#include <stack>
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
+#include <functional>
 #include <mutex>
 
+// minimum number of arguments for computing the SCCs in parallel
+#ifndef PARALLEL_SCC_THRESHOLD
+#define PARALLEL_SCC_THRESHOLD 1000000
+#endif
+
 using namespace std;
 
 void print_extension(const AF & af, const std::vector<uint32_t> & extension)
@@ -50,22 +57,17 @@ void print_extension_ee(const std::set<string> & extension) {
 	std::cout << "]";
 }
 
-AF getReduct(const AF & af, vector<string> ext, vector<pair<string,string>> & atts) {
-	if (ext.empty()) {
-		return af;
-	}
+// subframework of af without the arguments in 'removed_args', SCCs and grounded labelling are carried over (see getReduct)
+static AF getSubframework(const AF & af, const std::unordered_set<uint32_t> & removed_args, vector<pair<string,string>> & atts) {
 	AF reduct = AF();
 
-	std::unordered_set<uint32_t> removed_args;
-	for (const auto& arg: ext) {
-		uint32_t arg_id = af.arg_to_int.find(arg)->second;
-		removed_args.insert(arg_id);
-		removed_args.insert(af.attacked[arg_id].begin(), af.attacked[arg_id].end());
-	}
+	vector<uint32_t> origin;
+	origin.reserve(af.args - removed_args.size());
 	for (uint32_t i = 0; i < af.args; i++) {
 		string arg_str = af.int_to_arg[i];
 		if (!removed_args.count(i)) {
 			reduct.add_argument(arg_str);
+			origin.push_back(i);
 		}
 	}
 
@@ -97,82 +99,452 @@ AF getReduct(const AF & af, vector<string> ext, vector<pair<string,string>> & at
 			reduct.add_attack(att);
 		}
 	}
+
+	if (af.sccs.is_computed()) {
+		refineStronglyConnectedComponents(af, reduct, origin, reduct.sccs);
+	}
+	if (af.grounded.is_computed()) {
+		vector<uint32_t> removed(removed_args.begin(), removed_args.end());
+		updateGroundedLabelling(af, reduct, origin, removed, reduct.grounded);
+	}
 	return reduct;
 }
 
+/*
+Computes the reduct of af wrt ext, i.e., removes ext and all arguments attacked by ext
+SCCs and grounded labelling of af are carried over to the reduct if they have been computed,
+the latter requires ext to be conflict-free together with the grounded extension (e.g. an admissible set)
+*/
+AF getReduct(const AF & af, vector<string> ext, vector<pair<string,string>> & atts) {
+	if (ext.empty()) {
+		return af;
+	}
+
+	std::unordered_set<uint32_t> removed_args;
+	for (const auto& arg: ext) {
+		uint32_t arg_id = af.arg_to_int.find(arg)->second;
+		removed_args.insert(arg_id);
+		removed_args.insert(af.attacked[arg_id].begin(), af.attacked[arg_id].end());
+	}
+	return getSubframework(af, removed_args, atts);
+}
+
+// keys of all arguments of af (see argument_key), the fingerprint of the keys identifies a reduct independently of the path that led to it
+vector<uint64_t> getArgumentKeys(const AF & af) {
+	vector<uint64_t> keys;
+	keys.reserve(af.args);
+	for (auto const& arg: af.int_to_arg) {
+		keys.push_back(argument_key(arg));
+	}
+	return keys;
+}
+
+// marks the arguments that have an attack path to 'arg' (including 'arg' itself)
+vector<uint8_t> getUpstreamArguments(const AF & af, uint32_t arg) {
+	vector<uint8_t> upstream(af.args, 0);
+	vector<uint32_t> stack(1, arg);
+	upstream[arg] = 1;
+	while (!stack.empty()) {
+		uint32_t a = stack.back();
+		stack.pop_back();
+		for (auto const& attacker: af.attackers[a]) {
+			if (!upstream[attacker]) {
+				upstream[attacker] = 1;
+				stack.push_back(attacker);
+			}
+		}
+	}
+	return upstream;
+}
+
+/*
+Restricts af to the arguments marked in 'keep', which must contain all attackers of kept arguments (see getUpstreamArguments)
+No kept argument loses an attacker, so SCCs and grounded labelling are carried over as for a reduct.
+*/
+AF getRestriction(const AF & af, const vector<uint8_t> & keep, vector<pair<string,string>> & atts) {
+	std::unordered_set<uint32_t> removed_args;
+	for (uint32_t i = 0; i < af.args; i++) {
+		if (!keep[i]) {
+			removed_args.insert(i);
+		}
+	}
+	if (removed_args.empty()) {
+		return af;
+	}
+	return getSubframework(af, removed_args, atts);
+}
+
 /*
  * The following functions for working with SCCs have been adapted from the fudge argumentation-solver
  * which is subject to the GPL3 licence. 
 */
-int __scc__compute_strongly_connected_components(int idx, uint32_t v, stack<uint32_t>* arg_stack, vector<vector<uint32_t>>* sccs, const AF & af, int index[], int lowlink[], bool stack_member[]) {
-    index[v] = idx;
-	lowlink[v] = idx;
-	idx++;
-    arg_stack->push(v);
-	stack_member[v] = true;
-    for(auto const& w: af.attacked[v]){
-        if (index[w] == -1) {
-	        idx = __scc__compute_strongly_connected_components(idx, w, arg_stack, sccs, af, index, lowlink, stack_member);
-    	    lowlink[v] = lowlink[v] > lowlink[w] ? lowlink[w] : lowlink[v];
-	    } else if (stack_member[w]) {
-            lowlink[v] = lowlink[v] > index[w] ? index[w] : lowlink[v];
-        }
-	}
-    if(lowlink[v] == index[v]){
-        vector<uint32_t> scc;
-        
-        uint32_t w;
-        do {
-            w = arg_stack->top();
-            arg_stack->pop();
-			stack_member[w] = false;
-            scc.push_back(w);
-        } while ( v != w);
-        sccs->push_back(scc);
+
+/*
+Iterative version of Tarjan's algorithm, starting a depth-first search from 'root'
+If 'scope' is given, only arguments a with scope[a] == scope_id are visited
+Completed SCCs are appended to 'sccs'
+*/
+static void tarjan_search(const AF & af, uint32_t root, const uint32_t * scope, uint32_t scope_id, uint32_t & idx, SCCs & sccs, SCCScratch & scratch) {
+	const uint32_t unvisited = UINT32_MAX;
+	scratch.index[root] = scratch.lowlink[root] = idx++;
+	scratch.arg_stack.push_back(root);
+	scratch.stack_member[root] = true;
+	// each frame holds an argument and the position of the next attacked argument to visit
+	scratch.call_stack.push_back(make_pair(root, 0));
+
+	while (!scratch.call_stack.empty()) {
+		uint32_t v = scratch.call_stack.back().first;
+		uint32_t pos = scratch.call_stack.back().second;
+		if (pos < af.attacked[v].size()) {
+			scratch.call_stack.back().second++;
+			uint32_t w = af.attacked[v][pos];
+			if (scope != NULL && scope[w] != scope_id) {
+				continue;
+			}
+			if (scratch.index[w] == unvisited) {
+				scratch.index[w] = scratch.lowlink[w] = idx++;
+				scratch.arg_stack.push_back(w);
+				scratch.stack_member[w] = true;
+				scratch.call_stack.push_back(make_pair(w, 0));
+			} else if (scratch.stack_member[w]) {
+				scratch.lowlink[v] = min(scratch.lowlink[v], scratch.index[w]);
+			}
+			continue;
+		}
+
+		// all successors of v have been visited, check whether v is the root of an SCC
+		if (scratch.lowlink[v] == scratch.index[v]) {
+			uint32_t scc_id = sccs.num_sccs();
+			uint32_t w;
+			do {
+				w = scratch.arg_stack.back();
+				scratch.arg_stack.pop_back();
+				scratch.stack_member[w] = false;
+				sccs.component[w] = scc_id;
+				sccs.members.push_back(w);
+			} while (v != w);
+			sccs.offsets.push_back(sccs.members.size());
+		}
+		scratch.call_stack.pop_back();
+		if (!scratch.call_stack.empty()) {
+			uint32_t u = scratch.call_stack.back().first;
+			scratch.lowlink[u] = min(scratch.lowlink[u], scratch.lowlink[v]);
+		}
 	}
-	return idx;
+}
+
+static void reset_sccs(const AF & af, SCCs & sccs, SCCScratch & scratch) {
+	sccs.component.assign(af.args, UINT32_MAX);
+	sccs.members.clear();
+	sccs.members.reserve(af.args);
+	sccs.offsets.assign(1, 0);
+
+	scratch.index.assign(af.args, UINT32_MAX);
+	scratch.lowlink.resize(af.args);
+	scratch.stack_member.assign(af.args, false);
+	scratch.arg_stack.clear();
+	scratch.call_stack.clear();
 }
 
 // computes the set of strongly connected components using Tarjan's algorithm
-vector<vector<uint32_t>> computeStronglyConnectedComponents(const AF & af) {
-    vector<vector<uint32_t>>* sccs = new vector<vector<uint32_t>>();
-    int idx = 0;
-    stack<uint32_t>* arg_stack = new stack<uint32_t>();
-
-    int* index = new int[af.args];
-    int* lowlink = new int[af.args];
-	bool* stack_member = new bool[af.args];
-    for (size_t i = 0; i < af.args; i++) {
-		index[i] = -1;
-		lowlink[i] = -1;
-		stack_member[i] = false;
+void computeStronglyConnectedComponents(const AF & af, SCCs & sccs, SCCScratch & scratch) {
+	reset_sccs(af, sccs, scratch);
+	uint32_t idx = 0;
+	for (uint32_t root = 0; root < af.args; root++) {
+		if (scratch.index[root] == UINT32_MAX) {
+			tarjan_search(af, root, NULL, 0, idx, sccs, scratch);
+		}
+	}
+}
+
+// scratch buffers of the calling thread, reused by all SCC computations of that thread
+static thread_local SCCScratch thread_scratch;
+
+// computes the SCCs with the scratch buffers of the calling thread, very large frameworks are decomposed in parallel
+void computeStronglyConnectedComponents(const AF & af, SCCs & sccs) {
+	if (af.args >= PARALLEL_SCC_THRESHOLD && Scheduler::instance().num_threads() > 1) {
+		computeStronglyConnectedComponentsParallel(af, sccs, Scheduler::instance().num_threads());
+	} else {
+		computeStronglyConnectedComponents(af, sccs, thread_scratch);
+	}
+}
+
+/*
+Derives the SCCs of 'reduct' from the (already computed) SCCs of 'af'
+Every SCC of the reduct lies inside a single SCC of af, so SCCs of af that did not lose any argument are reused as they are,
+and Tarjan's algorithm is only run inside the SCCs that lost arguments. The resulting order is again reverse topological.
+
+@param af		the argumentation framework, with af.sccs computed
+@param reduct	a reduct of af
+@param origin	maps each argument of the reduct to its id in af
+@param sccs		the SCCs of the reduct
+*/
+void refineStronglyConnectedComponents(const AF & af, const AF & reduct, const vector<uint32_t> & origin, SCCs & sccs) {
+	SCCScratch & scratch = thread_scratch;
+	reset_sccs(reduct, sccs, scratch);
+
+	// scope[a] is the SCC of af that contains the argument a of the reduct
+	static thread_local vector<uint32_t> scope;
+	static thread_local vector<uint32_t> survivors;
+	static thread_local vector<uint32_t> to_reduct;
+	scope.resize(reduct.args);
+	survivors.assign(af.sccs.num_sccs(), 0);
+	to_reduct.assign(af.args, UINT32_MAX);
+	for (uint32_t i = 0; i < reduct.args; i++) {
+		scope[i] = af.sccs.component[origin[i]];
+		survivors[scope[i]]++;
+		to_reduct[origin[i]] = i;
+	}
+
+	uint32_t idx = 0;
+	for (uint32_t c = 0; c < af.sccs.num_sccs(); c++) {
+		if (survivors[c] == 0) {
+			continue;
+		}
+		if (survivors[c] == af.sccs.scc_size(c)) {
+			// untouched SCC, copy it over
+			uint32_t scc_id = sccs.num_sccs();
+			for (uint32_t j = af.sccs.offsets[c]; j < af.sccs.offsets[c+1]; j++) {
+				uint32_t arg = to_reduct[af.sccs.members[j]];
+				sccs.component[arg] = scc_id;
+				sccs.members.push_back(arg);
+			}
+			sccs.offsets.push_back(sccs.members.size());
+			continue;
+		}
+		// the SCC lost arguments and may fall apart, decompose the remaining arguments
+		for (uint32_t j = af.sccs.offsets[c]; j < af.sccs.offsets[c+1]; j++) {
+			uint32_t arg = to_reduct[af.sccs.members[j]];
+			if (arg != UINT32_MAX && scratch.index[arg] == UINT32_MAX) {
+				tarjan_search(reduct, arg, scope.data(), c, idx, sccs, scratch);
+			}
+		}
 	}
-	
-    for(uint32_t i = 0; i < af.args; i++) {
-        if(index[i] == -1) {
-            idx = __scc__compute_strongly_connected_components(idx,i,arg_stack,sccs,af,index,lowlink, stack_member);
-        }
-    }
-    return *sccs;
 }
 
 // print the set of strongly connected components
-void print_sccs(const AF & af, vector<vector<uint32_t>> sccs) {
-    for(auto const& scc: sccs) {
+void print_sccs(const AF & af, const SCCs & sccs) {
+    for (uint32_t i = 0; i < sccs.num_sccs(); i++) {
         cout << "<";
-        char isFirst = true;
-        for(auto const& arg: scc) {
-            if (isFirst) {
-                isFirst = false;
-                cout << af.int_to_arg[arg];
-            } else {
-				cout << "," << af.int_to_arg[arg];
-			}
+        for (uint32_t j = sccs.offsets[i]; j < sccs.offsets[i+1]; j++) {
+            if (j != sccs.offsets[i]) {
+                cout << ",";
+            }
+            cout << af.int_to_arg[sccs.members[j]];
         }
         cout << ">\n";
     }
 }
 
+/*
+Weakly connected components, i.e., connected components when the direction of the attacks is ignored
+Components are numbered in the order of their smallest argument.
+
+@returns the number of components, 'component' holds the component of each argument
+*/
+uint32_t computeWeaklyConnectedComponents(const AF & af, vector<uint32_t> & component) {
+	component.assign(af.args, UINT32_MAX);
+	uint32_t num_components = 0;
+	vector<uint32_t> stack;
+	for (uint32_t root = 0; root < af.args; root++) {
+		if (component[root] != UINT32_MAX) {
+			continue;
+		}
+		component[root] = num_components;
+		stack.push_back(root);
+		while (!stack.empty()) {
+			uint32_t arg = stack.back();
+			stack.pop_back();
+			for (int forward = 0; forward < 2; forward++) {
+				for (auto const& next: forward ? af.attacked[arg] : af.attackers[arg]) {
+					if (component[next] == UINT32_MAX) {
+						component[next] = num_components;
+						stack.push_back(next);
+					}
+				}
+			}
+		}
+		num_components++;
+	}
+	return num_components;
+}
+
+/*
+Flags the members of 'scc' that are attacked by an argument outside of it, in the order of 'scc'
+An admissible subset of the SCC cannot defend these arguments: attacking the outside attacker back would put it into the SCC.
+So the initial sets within the SCC are those of the SCC without the flagged arguments.
+*/
+vector<uint8_t> getAttackedFromOutside(const AF & af, const vector<uint32_t> & scc) {
+	// members are looked up by binary search to stay independent of the size of the framework
+	vector<uint32_t> members(scc);
+	sort(members.begin(), members.end());
+	vector<uint8_t> attacked(scc.size(), 0);
+	for (uint32_t i = 0; i < scc.size(); i++) {
+		for (auto const& attacker: af.attackers[scc[i]]) {
+			if (!binary_search(members.begin(), members.end(), attacker)) {
+				attacked[i] = 1;
+				break;
+			}
+		}
+	}
+	return attacked;
+}
+
+/*
+Fingerprint of an SCC together with its arguments that are attacked from outside the SCC
+This determines the initial sets within the SCC (see getAttackedFromOutside).
+*/
+Fingerprint getSCCContextFingerprint(const AF & af, const SCCs & sccs, uint32_t scc) {
+	vector<uint32_t> members(sccs.members.begin() + sccs.offsets[scc], sccs.members.begin() + sccs.offsets[scc+1]);
+	vector<uint8_t> attacked = getAttackedFromOutside(af, members);
+	vector<uint64_t> keys;
+	for (uint32_t i = 0; i < members.size(); i++) {
+		uint64_t key = argument_key(af.int_to_arg[members[i]]);
+		keys.push_back(key);
+		if (attacked[i]) {
+			keys.push_back(~key);
+		}
+	}
+	return fingerprint(keys);
+}
+
+/*
+Key of each SCC that identifies it independently of the argument ids, i.e., the same SCC has the same key in every reduct
+*/
+vector<uint64_t> computeSCCKeys(const AF & af, const SCCs & sccs) {
+	vector<uint64_t> keys(sccs.num_sccs(), UINT64_MAX);
+	for (uint32_t i = 0; i < sccs.num_sccs(); i++) {
+		for (uint32_t j = sccs.offsets[i]; j < sccs.offsets[i+1]; j++) {
+			keys[i] = min(keys[i], argument_key(af.int_to_arg[sccs.members[j]]));
+		}
+	}
+	return keys;
+}
+
+/*
+Partial-order reduction of the serialisation search
+Initial sets of two SCCs that are not connected by any path commute: adding one of them leaves the other SCC and everything
+upstream of it untouched, so both orders lead to the same reduct. Only the order with the smaller SCC key first is explored.
+
+Adding an initial set never changes the initial sets of unconnected SCCs, so blocking only the SCCs that currently have initial sets
+('candidates') suffices, which keeps the blocked lists short. Exploring the branch with the smallest SCC key first never runs into
+a state whose initial sets are all blocked, the first path of a depth-first search thus always reaches a maximal extension.
+
+Connectivity is computed on the condensation: for blocks of 64 candidates, one sweep in topological order collects for every SCC
+the candidates that reach it, and one sweep in reverse order the candidates it reaches.
+
+@returns for each candidate SCC, the sorted keys of the candidate SCCs that are unconnected to it and have a smaller key,
+		 i.e., the SCCs whose initial sets must not be added directly after an initial set of that SCC (empty for other SCCs)
+*/
+vector<vector<uint64_t>> computeCommutingSCCs(const AF & af, const SCCs & sccs, const vector<uint64_t> & keys, const vector<uint8_t> & candidates) {
+	static thread_local vector<pair<uint32_t,uint32_t>> edges;
+	static thread_local vector<uint32_t> members;
+	static thread_local vector<uint64_t> reached;
+	static thread_local vector<uint64_t> reaching;
+
+	// attacks between SCCs, by decreasing source, i.e., in topological order as the SCCs are stored in reverse topological order
+	edges.clear();
+	for (uint32_t a = 0; a < af.args; a++) {
+		for (auto const& b: af.attacked[a]) {
+			if (sccs.component[a] != sccs.component[b]) {
+				edges.push_back(make_pair(sccs.component[a], sccs.component[b]));
+			}
+		}
+	}
+	sort(edges.begin(), edges.end(), greater<pair<uint32_t,uint32_t>>());
+	edges.erase(unique(edges.begin(), edges.end()), edges.end());
+
+	members.clear();
+	for (uint32_t i = 0; i < sccs.num_sccs(); i++) {
+		if (candidates[i]) {
+			members.push_back(i);
+		}
+	}
+
+	vector<vector<uint64_t>> commuting(sccs.num_sccs());
+	for (size_t block = 0; block < members.size(); block += 64) {
+		size_t end = min(block + 64, members.size());
+		// bit c - block of reached[i] (reaching[i]) is set if the SCC i is reachable from (reaches) the candidate members[c]
+		reached.assign(sccs.num_sccs(), 0);
+		reaching.assign(sccs.num_sccs(), 0);
+		for (size_t c = block; c < end; c++) {
+			reached[members[c]] = reaching[members[c]] = 1ULL << (c - block);
+		}
+		for (auto const& e: edges) {
+			reached[e.second] |= reached[e.first];
+		}
+		for (auto e = edges.rbegin(); e != edges.rend(); ++e) {
+			reaching[e->first] |= reaching[e->second];
+		}
+		for (auto const& scc: members) {
+			uint64_t connected = reached[scc] | reaching[scc];
+			for (size_t c = block; c < end; c++) {
+				if (!(connected >> (c - block) & 1) && keys[members[c]] < keys[scc]) {
+					commuting[scc].push_back(keys[members[c]]);
+				}
+			}
+		}
+	}
+	for (auto & list: commuting) {
+		sort(list.begin(), list.end());
+	}
+	return commuting;
+}
+
+uint64_t CommutingSCCs::key(uint32_t scc) {
+	if (keys.empty()) {
+		keys = computeSCCKeys(af, af.sccs);
+	}
+	return keys[scc];
+}
+
+const vector<uint64_t> & CommutingSCCs::get(uint32_t scc) {
+	if (commuting.empty()) {
+		key(scc);
+		commuting = computeCommutingSCCs(af, af.sccs, keys, candidates);
+	}
+	return commuting[scc];
+}
+
+/*
+Challenge graph of a list of initial sets: 'sets[i]' and 'sets[j]' are adjacent if an argument of one attacks an argument of the other
+Attacks between admissible sets always go both ways, so the graph is undirected. The members of all sets are indexed once,
+sorted by argument, so every attack of every member is only looked up once instead of comparing all pairs of sets.
+The index only covers the given sets, so calling this for the initial sets of each SCC separately stays linear overall.
+*/
+vector<vector<uint32_t>> getChallengeGraph(const AF & af, const vector<vector<uint32_t>> & sets) {
+	// (argument, set containing it)
+	vector<pair<uint32_t,uint32_t>> owners;
+	for (uint32_t i = 0; i < sets.size(); i++) {
+		for (auto const& arg: sets[i]) {
+			owners.push_back(make_pair(arg, i));
+		}
+	}
+	sort(owners.begin(), owners.end());
+
+	vector<vector<uint32_t>> graph(sets.size());
+	// last set that added each set as a neighbour, plus one
+	vector<uint32_t> seen(sets.size(), 0);
+	for (uint32_t i = 0; i < sets.size(); i++) {
+		seen[i] = i + 1;
+		for (auto const& arg: sets[i]) {
+			for (int forward = 0; forward < 2; forward++) {
+				for (auto const& other: forward ? af.attacked[arg] : af.attackers[arg]) {
+					auto it = lower_bound(owners.begin(), owners.end(), make_pair(other, uint32_t(0)));
+					for (; it != owners.end() && it->first == other; ++it) {
+						uint32_t j = it->second;
+						if (seen[j] != i + 1) {
+							seen[j] = i + 1;
+							graph[i].push_back(j);
+						}
+					}
+				}
+			}
+		}
+	}
+	return graph;
+}
+
 mutex mtx_log;
 
 void log(int thread_id, string output) {
@@ -3,4 +3,52 @@
 ./serial-solver -p DS-PR -fo tgf -f examples/A-1-BA_40_80_5.tgf -a a36
 ./serial-solver -p DS-PR -fo tgf -f examples/B-2-comune-di-castellanza_20151218_2338.gml.80.tgf -a a31
 ./serial-solver -p DS-PR -fo tgf -f examples/A-1-BA_60_70_3.tgf -a a12
-./serial-solver.sh -p DS-PR -fo tgf -f examples/T-1-cascadespoint-or-us.gml.20.tgf -a a5
\ No newline at end of file
+./serial-solver.sh -p DS-PR -fo tgf -f examples/T-1-cascadespoint-or-us.gml.20.tgf -a a5
+
+# parallel SCC decomposition and grounded labelling forced on small frameworks, compared against Tarjan and the sequential labelling
+make -s TARGET=serial-solver-parallel BUILDDIR=build-parallel CXX="g++ -DPARALLEL_SCC_THRESHOLD=2 -DPARALLEL_GROUNDED_THRESHOLD=2" > /dev/null || exit 1
+for f in examples/A-1-*.tgf examples/B-2-*.tgf examples/T-1-*.tgf examples/example*.tgf; do
+	a=$(head -n 1 "$f")
+	for p in SE-GR CE-IT DS-PR; do
+		expected=$(./serial-solver -j 1 -p $p -fo tgf -f "$f" -a $a | tr -d '[]' | tr ',' '\n' | sort)
+		actual=$(./serial-solver-parallel -j 4 -p $p -fo tgf -f "$f" -a $a | tr -d '[]' | tr ',' '\n' | sort)
+		if [ "$expected" != "$actual" ]; then
+			echo "parallel $p differs from sequential on $f"
+		fi
+	done
+done
+
+# output of one run with the extensions and their arguments in a fixed order, fails if the run takes longer than 5 seconds
+run_normalised() {
+	local out
+	out=$(timeout 5 "$@") || return 1
+	case "$*" in
+		*EE-*) echo "$out" | tr -d ' ' | sed 's/^\[\[//; s/\]\]$//; s/\],*\[/\n/g' | while read -r set; do echo "$set" | tr ',' '\n' | sort | tr '\n' ' '; echo; done | sort ;;
+		*) echo "$out" ;;
+	esac
+}
+
+# the kernel leaves all extensions, counts and answers unchanged
+for f in examples/*.tgf; do
+	a=$(head -n 1 "$f")
+	for p in EE-IT CE-IT EE-UC DS-UC; do
+		expected=$(run_normalised ./serial-solver --no-kernel -p $p -fo tgf -f "$f" -a $a) || continue
+		actual=$(run_normalised ./serial-solver -p $p -fo tgf -f "$f" -a $a) || continue
+		if [ "$expected" != "$actual" ]; then
+			echo "kernel changes $p on $f"
+		fi
+	done
+done
+
+# closed forms and the search of small SCCs disabled, all initial sets are searched with the SAT solver
+make -s TARGET=serial-solver-sat BUILDDIR=build-sat CXX="g++ -DSCC_FAST_PATHS=0" > /dev/null || exit 1
+for f in examples/*.tgf; do
+	a=$(head -n 1 "$f")
+	for p in EE-IT CE-IT DS-PR EE-UC DS-UC; do
+		expected=$(run_normalised ./serial-solver-sat -p $p -fo tgf -f "$f" -a $a) || continue
+		actual=$(run_normalised ./serial-solver -p $p -fo tgf -f "$f" -a $a) || continue
+		if [ "$expected" != "$actual" ]; then
+			echo "SAT-free initial sets change $p on $f"
+		fi
+	done
+done